@@ -0,0 +1,258 @@
+/*! \file gps-trace.cpp
+	Convert the binary channel trace (channels.trc, written with -c) to CSV for matlab
+*/
+/************************************************************************************************
+Copyright 2008 Gregory W Heckler
+
+This file is part of the GPS Software Defined Radio (GPS-SDR)
+
+The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+GNU General Public License as published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The GPS-SDR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with GPS-SDR; if not,
+write to the:
+
+Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+************************************************************************************************/
+
+#define GLOBALS_HERE
+
+#include "includes.h"
+#include "tracer.h"
+
+/*----------------------------------------------------------------------------------------------*/
+void usage(char *_str)
+{
+
+	fprintf(stdout,"usage: %s [-c chan] [-s sv] [-i] [file]\n",_str);
+	fprintf(stdout,"  -c chan  only this channel\n");
+	fprintf(stdout,"  -s sv    only this SV (0 based, as in the receiver)\n");
+	fprintf(stdout,"  -i       summarize the index instead of converting\n");
+	fprintf(stdout,"Writes the records as CSV to stdout, file defaults to ./channels.trc\n");
+	fflush(stdout);
+
+	exit(1);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Read the index from the footer, or rebuild it from the block headers if the receiver never got to
+ * write one. Returns the number of blocks.
+ * */
+int32 read_index(FILE *_fp, Trace_Block_S **_index)
+{
+
+	Trace_Footer_S footer;
+	Trace_Block_S block;
+	Trace_Block_S *index;
+	int32 blocks, size;
+	int64 offset;
+
+	/* A cleanly closed file */
+	if((fseeko64(_fp, -(int64)sizeof(Trace_Footer_S), SEEK_END) == 0) &&
+	   (fread(&footer, sizeof(Trace_Footer_S), 1, _fp) == 1) &&
+	   (footer.magic == TRACE_INDEX_MAGIC) && (footer.blocks >= 0))
+	{
+		index = (Trace_Block_S *)malloc((footer.blocks + 1)*sizeof(Trace_Block_S));
+		fseeko64(_fp, footer.offset, SEEK_SET);
+		if(fread(index, sizeof(Trace_Block_S), footer.blocks, _fp) == (size_t)footer.blocks)
+		{
+			*_index = index;
+			return(footer.blocks);
+		}
+		free(index);
+	}
+
+	/* Walk the blocks, stopping at the index or a torn block */
+	fprintf(stderr,"No index, scanning the blocks\n");
+
+	size = 1024;
+	blocks = 0;
+	index = (Trace_Block_S *)malloc(size*sizeof(Trace_Block_S));
+	offset = sizeof(Trace_File_Header_S);
+
+	while((fseeko64(_fp, offset, SEEK_SET) == 0) && (fread(&block, sizeof(Trace_Block_S), 1, _fp) == 1))
+	{
+		if((block.magic != TRACE_BLOCK_MAGIC) || (block.offset != offset) || (block.records <= 0))
+			break;
+
+		if(blocks == size)
+		{
+			size *= 2;
+			index = (Trace_Block_S *)realloc(index, size*sizeof(Trace_Block_S));
+		}
+
+		index[blocks++] = block;
+		offset += sizeof(Trace_Block_S) + (int64)block.records*sizeof(Trace_Record_S);
+	}
+
+	/* The last block may have been cut short */
+	fseeko64(_fp, 0, SEEK_END);
+	if((blocks > 0) && (offset > ftello64(_fp)))
+		blocks--;
+
+	*_index = index;
+	return(blocks);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void summarize(Trace_Block_S *_index, int32 _blocks, int32 _chan)
+{
+
+	int32 lcv, chan;
+	int32 blocks[MAX_CHANNELS];
+	uint32 records[MAX_CHANNELS], first[MAX_CHANNELS], last[MAX_CHANNELS], drops[MAX_CHANNELS];
+
+	memset(blocks, 0x0, sizeof(blocks));
+	memset(records, 0x0, sizeof(records));
+	memset(drops, 0x0, sizeof(drops));
+
+	for(lcv = 0; lcv < _blocks; lcv++)
+	{
+		chan = _index[lcv].chan;
+		if((chan < 0) || (chan >= MAX_CHANNELS))
+			continue;
+
+		if(blocks[chan] == 0)
+			first[chan] = _index[lcv].first_tic;
+
+		blocks[chan]++;
+		records[chan] += _index[lcv].records;
+		last[chan] = _index[lcv].last_tic;
+		drops[chan] = _index[lcv].drops;
+	}
+
+	fprintf(stdout,"chan,blocks,records,first_tic,last_tic,drops\n");
+	for(chan = 0; chan < MAX_CHANNELS; chan++)
+	{
+		if((blocks[chan] == 0) || ((_chan != -1) && (chan != _chan)))
+			continue;
+
+		fprintf(stdout,"%d,%d,%u,%u,%u,%u\n",chan,blocks[chan],records[chan],first[chan],last[chan],drops[chan]);
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+int main(int32 argc, char **argv)
+{
+
+	FILE *fp;
+	const char *fname;
+	Trace_File_Header_S header;
+	Trace_Block_S *index;
+	Trace_Record_S *records, *r;
+	int32 lcv, lcv2, blocks, chan, sv, info, size;
+
+	fname = "./channels.trc";
+	chan = sv = -1;
+	info = 0;
+
+	for(lcv = 1; lcv < argc; lcv++)
+	{
+		if((strcmp(argv[lcv], "-c") == 0) && (lcv + 1 < argc))
+			chan = atoi(argv[++lcv]);
+		else if((strcmp(argv[lcv], "-s") == 0) && (lcv + 1 < argc))
+			sv = atoi(argv[++lcv]);
+		else if(strcmp(argv[lcv], "-i") == 0)
+			info = 1;
+		else if(argv[lcv][0] == '-')
+			usage(argv[0]);
+		else
+			fname = argv[lcv];
+	}
+
+	fp = fopen64(fname, "rb");
+	if(fp == NULL)
+	{
+		fprintf(stderr,"Could not open %s\n",fname);
+		return(1);
+	}
+
+	if((fread(&header, sizeof(Trace_File_Header_S), 1, fp) != 1) || (header.magic != TRACE_FILE_MAGIC))
+	{
+		fprintf(stderr,"%s is not a channel trace\n",fname);
+		fclose(fp);
+		return(1);
+	}
+
+	if((header.version != TRACE_FILE_VERSION) || (header.record_size != (int32)sizeof(Trace_Record_S)))
+	{
+		fprintf(stderr,"%s is trace version %u with %d byte records, expected version %d with %d\n",
+			fname, header.version, header.record_size, TRACE_FILE_VERSION, (int32)sizeof(Trace_Record_S));
+		fclose(fp);
+		return(1);
+	}
+
+	blocks = read_index(fp, &index);
+
+	if(info)
+	{
+		summarize(index, blocks, chan);
+		free(index);
+		fclose(fp);
+		return(0);
+	}
+
+	fprintf(stdout,"tic,chan,sv,state,antenna,len,count,I_early,I_prompt,I_late,Q_early,Q_prompt,Q_late,"
+		"carrier_nco,code_nco,cn0,p_avg,w,x,z,bit_lock,frame_lock,freq_lock,navigate,subframe,best_epoch,pull_in\n");
+
+	size = 0;
+	records = NULL;
+
+	/* Jump straight to the wanted channel's blocks */
+	for(lcv = 0; lcv < blocks; lcv++)
+	{
+		if((chan != -1) && (index[lcv].chan != chan))
+			continue;
+
+		if(index[lcv].records > size)
+		{
+			size = index[lcv].records;
+			records = (Trace_Record_S *)realloc(records, size*sizeof(Trace_Record_S));
+		}
+
+		fseeko64(fp, index[lcv].offset + sizeof(Trace_Block_S), SEEK_SET);
+		if(fread(records, sizeof(Trace_Record_S), index[lcv].records, fp) != (size_t)index[lcv].records)
+		{
+			fprintf(stderr,"Block %d is truncated\n",lcv);
+			break;
+		}
+
+		for(lcv2 = 0; lcv2 < index[lcv].records; lcv2++)
+		{
+			r = &records[lcv2];
+			if((sv != -1) && (r->sv != sv))
+				continue;
+
+			fprintf(stdout,"%u,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.6f,%.6f,%.3f,%.1f,%.6g,%.6g,%.6g,%d,%d,%d,%d,%d,%d,%d\n",
+				r->tic, r->chan, r->sv, r->state, r->antenna, r->len, r->count,
+				r->I[0], r->I[1], r->I[2], r->Q[0], r->Q[1], r->Q[2],
+				r->carrier_nco, r->code_nco, r->cn0, r->p_avg, r->w, r->x, r->z,
+				(r->flags & TRACE_BIT_LOCK) != 0, (r->flags & TRACE_FRAME_LOCK) != 0,
+				(r->flags & TRACE_FREQ_LOCK) != 0, (r->flags & TRACE_NAVIGATE) != 0,
+				r->subframe, r->best_epoch, r->pull_in);
+		}
+	}
+
+	free(records);
+	free(index);
+	fclose(fp);
+
+	return(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
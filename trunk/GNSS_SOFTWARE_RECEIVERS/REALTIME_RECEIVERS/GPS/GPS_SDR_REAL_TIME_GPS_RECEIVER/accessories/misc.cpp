@@ -260,6 +260,37 @@ int32 run_agc(CPX *_buff, int32 _samps, int32 _bits, int32 _scale)
 /*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Histogram of the component magnitudes, AGC_HIST_BINS equal bins up to 1 << _bits, the last bin
+ * also holds everything above
+ * */
+void agc_hist(CPX *_buff, int32 _samps, int32 _bits, uint32 *_hist)
+{
+	int32 lcv, bin, val, width;
+	int16 *p;
+
+	p = (int16 *)&_buff[0];
+
+	width = (1 << _bits)/AGC_HIST_BINS;
+	if(width < 1)
+		width = 1;
+
+	memset(_hist, 0x0, AGC_HIST_BINS*sizeof(uint32));
+
+	for(lcv = 0; lcv < 2*_samps; lcv++)
+	{
+		val = abs(p[lcv]);
+		bin = val/width;
+		if(bin >= AGC_HIST_BINS)
+			bin = AGC_HIST_BINS - 1;
+		_hist[bin]++;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
 /*----------------------------------------------------------------------------------------------*/
 /*!
  * Get a rough first guess of scale value to quickly initialize agc
@@ -580,3 +611,78 @@ uint32 adler(uint8 *data, int32 len)
 }
 /*----------------------------------------------------------------------------------------------*/
 
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * gps_parity: Check the parity of a GPS word in the channel's format, bits 31 and 30 are D29* and D30*
+ * of the previous word, bits 29 to 6 the transmitted data and bits 5 to 0 the parity. The data is
+ * un-inverted by D30* first, then each row of the table picks out the bits of one of the parity
+ * equations in ICD-GPS-200 (D25 first) and the parity of the AND is that bit.
+ * */
+bool gps_parity(uint32 _word)
+{
+
+	static const uint32 equations[6] = {
+		0xBB1F3480,		/* D25 = D29* ^ d1 d2 d3 d5 d6 d10 d11 d12 d13 d14 d17 d18 d20 d23 */
+		0x5D8F9A40,		/* D26 = D30* ^ d2 d3 d4 d6 d7 d11 d12 d13 d14 d15 d18 d19 d21 d24 */
+		0xAEC7CD00,		/* D27 = D29* ^ d1 d3 d4 d5 d7 d8 d12 d13 d14 d15 d16 d19 d20 d22 */
+		0x5763E680,		/* D28 = D30* ^ d2 d4 d5 d6 d8 d9 d13 d14 d15 d16 d17 d20 d21 d23 */
+		0x6BB1F340,		/* D29 = D30* ^ d1 d3 d5 d6 d7 d9 d10 d14 d15 d16 d17 d18 d21 d22 d24 */
+		0x8B7A89C0		/* D30 = D29* ^ d3 d5 d6 d8 d9 d10 d11 d13 d15 d19 d22 d23 d24 */
+	};
+
+	int32 lcv;
+	uint32 parity;
+
+	if(_word & 0x40000000)
+		_word ^= 0x3FFFFFC0;
+
+	parity = 0;
+	for(lcv = 0; lcv < 6; lcv++)
+		parity = (parity << 1) | __builtin_parity(_word & equations[lcv]);
+
+	return(parity == (_word & 0x3F));
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * gps_preamble: Look for the TLM preamble at 32 alignments at once. The bits are packed MSB first,
+ * bit n of the stream in bit 31-(n%32) of _bits[n/32], in a ring of _words (a power of 2) words.
+ * Returns a mask with bit 31-t set if an upright or inverted preamble starts at bit _first+t, _first
+ * must be a multiple of 32. Each row of the bit-sliced compare is the stream shifted by one preamble
+ * bit, so 8 shifts and ANDs test all 32 starting points.
+ * */
+uint32 gps_preamble(uint32 *_bits, int32 _words, uint32 _first)
+{
+
+	int32 lcv;
+	uint32 w0, w1, row, upright, inverted;
+
+	w0 = _bits[(_first >> 5) & (_words - 1)];
+	w1 = _bits[((_first >> 5) + 1) & (_words - 1)];
+
+	upright = inverted = 0xFFFFFFFF;
+	for(lcv = 0; lcv < 8; lcv++)
+	{
+		row = lcv ? ((w0 << lcv) | (w1 >> (32 - lcv))) : w0;
+
+		if((PREAMBLE >> (7 - lcv)) & 0x1)
+		{
+			upright &= row;
+			inverted &= ~row;
+		}
+		else
+		{
+			upright &= ~row;
+			inverted &= row;
+		}
+	}
+
+	return(upright | inverted);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -40,6 +40,7 @@
 /* The most important thing, the NUMBER OF CORRELATORS IN THE RECEIVER and the NUMBER OF CPUs */
 /*----------------------------------------------------------------------------------------------*/
 #define MAX_CHANNELS			(12)						//!< Number of channel objects
+#define LOOP_BLOCKS				((MAX_CHANNELS+3)/4)		//!< Tracking loops are updated 4 channels to an SSE register
 #define CPU_CORES				(2)							//!< 1 for a single core, 2 for a dual core system, etc
 #define CORR_PER_CPU			(MAX_CHANNELS/CPU_CORES)	//!< Distribute them up evenly (this should be an INTEGER!)
 #define MAX_ANTENNAS			(2)							//!< The number of antennas
@@ -66,18 +67,26 @@
 #define MAX_DOPPLER_MEDIUM		(15000)			//!< Cold Doppler search space for strong signal
 #define MAX_DOPPLER_WEAK		(15000)			//!< Cold Doppler search space for weak signal
 #define MAX_DOPPLER_WARM		(1000)			//!< Search this much Doppler space if state information is available
+#define ACQ_BUDGET_WEAK			(500)			//!< A weak acquisition yields after this many ms and is resumed later
 #define ACQ_OPERATION_STRONG	(ACQ_OPERATION_COLD)	//!< Acq strong mode (2 = cold & warm)
 #define ACQ_OPERATION_MEDIUM	(ACQ_OPERATION_DISABLED)//!< Acq strong mode (2 = cold & warm)
 #define ACQ_OPERATION_WEAK		(ACQ_OPERATION_DISABLED)//!< Acq weak mode (2 = warm only)
 #define THRESH_STRONG			(0)						//!< Thats right zero! 40 dB-Hz and above acquisition threshold
 #define THRESH_MEDIUM			(0)						//!< Thats right zero! 30 dB-Hz and above acquisition threshold
 #define THRESH_WEAK				(0)						//!< 30 dB-Hz and below (down to ~22 dB-Hz <-- LIAR!) acquisition threshold
+#define ACQ_FINE_MS				(128)					//!< Length of the fine Doppler acquisition (ms), 0 to disable
+#define ACQ_FINE_STEP			(2.0)					//!< Spacing of the fine Doppler search on the squared prompt (Hz)
+#define ACQ_FINE_CONFIDENCE		(8.0)					//!< Fine peak must be this far above the mean of the sweep
+#define ACQ_FINE_PNR			(14.0)					//!< Only refine strong detections whose full resolution peak-to-noise clears this
+#define CODE_CACHE_DIR			"/tmp"					//!< Where the generated code spectra are cached
+#define THRESH_STRONG_PNR		(16.0)					//!< Default peak-to-noise ratio to stop a strong search early, 0 to search the whole range
 /*----------------------------------------------------------------------------------------------*/
 
 
 /* Correlator Defines */
 /*----------------------------------------------------------------------------------------------*/
 #define FRAME_SIZE_PLUS_2		(12)		//!< 10 words per frame, 12 = 10 + 2
+#define NAV_BITS				(1024)		//!< Data bits each channel keeps for frame sync, a power of 2
 #define CODE_BINS				(50)		//!< Partial code offset bins code resolution -> 1 chip/X bins
 #define CARRIER_SPACING			(10)		//!< Spacing of bins (Hz)
 #define CARRIER_BINS			(MAX_DOPPLER_ABSOLUTE/CARRIER_SPACING) //!< Number of pre-sampled carrier wipeoff bins
@@ -96,6 +105,14 @@
 /*----------------------------------------------------------------------------------------------*/
 
 
+/* Orbit Cache */
+/*----------------------------------------------------------------------------------------------*/
+#define ORBIT_CACHE				(1)			//!< Interpolate SV orbits from a fit instead of solving Kepler every epoch
+#define ORBIT_SPAN				(600.0)		//!< Each fit covers this many seconds
+#define ORBIT_TERMS				(8)			//!< Chebyshev terms per fit
+/*----------------------------------------------------------------------------------------------*/
+
+
 /* AGC Control */
 /*----------------------------------------------------------------------------------------------*/
 #define AGC_BITS				(6)			//!< AGC to this bit depth
@@ -103,6 +120,79 @@
 //#define OVERFLOW_HIGH			(1024)		//!< Overflow high
 #define OVERFLOW_LOW			(64)		//!< Overflow low
 #define OVERFLOW_HIGH			(512)		//!< Overflow high
+#define AGC_PERIOD				(256)		//!< Adjust the gains every this many ms (power of 2)
+#define AGC_HIST_BINS			(8)			//!< Bins in the sample magnitude histograms
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* File Playback */
+/*----------------------------------------------------------------------------------------------*/
+#define FILE_WINDOW_MS			(16000)		//!< Map recordings this many ms at a time, must exceed the FIFO depth
+#define WATCHDOG_MS				(1000)		//!< Watchdog period, in ms of samples when running off the sample clock
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Recorder */
+/*----------------------------------------------------------------------------------------------*/
+#define RECORD_BUFF_SIZE		(1<<20)		//!< Write the recording this many bytes at a time (per antenna)
+#define RECORD_ALIGN			(4096)		//!< Alignment of the record buffers, O_DIRECT needs the block size
+#define RECORD_DIRECT			(1)			//!< Bypass the page cache when writing the recording
+#define RECORD_PREALLOC_MS		(600000)	//!< Preallocate this much of the recording, 0 to not bother
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Channel Trace */
+/*----------------------------------------------------------------------------------------------*/
+#define TRACE_RING_BITS			(12)		//!< Each channel's trace ring holds 2^TRACE_RING_BITS dumps
+#define TRACE_PERIOD_MS			(100)		//!< Drain the trace rings every this many ms
+#define TRACE_BUFF_SIZE			(1<<18)		//!< Write the trace this many bytes at a time
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Sample Streams */
+/*----------------------------------------------------------------------------------------------*/
+#define STREAM_BATCH			(1<<20)		//!< Staging buffer of a sample stream (bytes)
+#define STREAM_RCVBUF			(8<<20)		//!< Ask for this much socket receive buffer (bytes)
+#define STREAM_MAX_DGRAM		(65536)		//!< Largest UDP datagram
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Signal Simulator */
+/*----------------------------------------------------------------------------------------------*/
+#define SIM_SHIFT				(6)			//!< Signals are summed at 2^SIM_SHIFT times the output scale
+#define SIM_NOISE				(8)			//!< 1 sigma of the output noise, per I or Q
+#define SIM_NOISE_BITS			(16)		//!< The noise pool holds 2^this samples (at most 16), each output sample is a fresh draw
+#define SIM_LUT_BITS			(10)		//!< Phase resolution of the carrier tables
+#define SIM_CN0					(45.0)		//!< Default C/N0 (dB-Hz)
+#define SIM_MAX_DOPPLER			(4000.0)	//!< Random scenarios draw the Doppler from +-this (Hz)
+#define SIM_MAX_DOPPLER_RATE	(1.0)		//!< and the Doppler rate from +-this (Hz/s)
+#define SIM_SEED				(0x5EED1234)	//!< Random scenarios are repeatable
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Frequency Lock */
+/*----------------------------------------------------------------------------------------------*/
+#define FLOCK_BINS				(64)		//!< Length of the sliding DFT of the squared prompts
+#define FLOCK_HOP				(16)		//!< Add the spectrum into the estimate every this many dumps
+#define FLOCK_SETTLE_MS			(200)		//!< Let a new channel settle this long before estimating
+#define FLOCK_MIN_WINDOWS		(4)			//!< Spectra needed before lock can be declared
+#define FLOCK_MAX_WINDOWS		(64)		//!< Take the best peak after this many spectra, confident or not
+#define FLOCK_CONFIDENCE		(10.0)		//!< Declare lock once the peak is this far above the mean of the other bins
+/*----------------------------------------------------------------------------------------------*/
+
+
+/* Overload Control */
+/*----------------------------------------------------------------------------------------------*/
+#define OVERLOAD_PERIOD			(100)		//!< Evaluate the load every this many ms
+#define OVERLOAD_SMOOTH			(4)			//!< Time constant of the correlation time filter (periods)
+#define OVERLOAD_UTIL_HI		(850)		//!< Overloaded above this correlation time per ms (us)
+#define OVERLOAD_UTIL_LO		(600)		//!< Relaxed below this correlation time per ms (us)
+#define OVERLOAD_FILL_HI		(20)		//!< Overloaded above this FIFO backlog (percent of the depth)
+#define OVERLOAD_FILL_LO		(2)			//!< Relaxed below this FIFO backlog (percent of the depth)
+#define OVERLOAD_HOLD_UP		(3)			//!< Periods of overload before stepping up
+#define OVERLOAD_HOLD_DOWN		(20)		//!< Periods of relief before stepping down
+#define OVERLOAD_YIELD			(4)			//!< Acquisition sleeps this many times longer when stretched
+#define OVERLOAD_MIN_CHANNELS	(4)			//!< Never shed below this many channels
 /*----------------------------------------------------------------------------------------------*/
 
 
@@ -43,17 +43,23 @@ EXTERN class Ephemeris		*pEphemeris;					//!< Extract the ephemeris
 EXTERN class Acquisition	*pAcquisition;					//!< Perform acquisitions
 EXTERN class Correlator		*pCorrelator;					//!< Correlator
 EXTERN class Channel		*pChannels[MAX_CHANNELS];		//!< Channels (uses correlations to close the loops)
+EXTERN class Loop_Bank		*pLoops;						//!< Tracking loops of all the channels
 EXTERN class SV_Select		*pSV_Select;					//!< Contains the channels and drives the channel objects
 EXTERN class Telemetry		*pTelemetry;					//!< Simple ncurses interface
 EXTERN class Commando		*pCommando;						//!< Process and execute commands
 EXTERN class GPS_Source		*pSource;						//!< Get the GPS data from somewhere
 EXTERN class Patience		*pPatience;						//!< Watchdog for GPS Source
+EXTERN class Recorder		*pRecorder;						//!< Records the IF data (-r), NULL if not recording
+EXTERN class Overload		*pOverload;						//!< Sheds load when the correlator falls behind
+EXTERN class Tracer			*pTracer;						//!< Binary channel trace (-c), NULL if not tracing
 /*----------------------------------------------------------------------------------------------*/
 
 /*----------------------------------------------------------------------------------------------*/
 EXTERN int32 grun;									//!< Keep all the threads active (technically, this should be mutex protected, but eh, who cares? )
 EXTERN Options_S gopt;								//!< Global receiver options
 EXTERN struct timeval starttime;					//!< Get receiver start time
+EXTERN volatile int32 gclock;						//!< Sample clock, packets (ms) produced by the FIFO
+EXTERN volatile int32 gsubframes;					//!< Subframes handed to the ephemeris, for the sample clock lockstep
 /*----------------------------------------------------------------------------------------------*/
 
 
@@ -71,7 +77,6 @@ EXTERN int32 EKF_2_SVS_P[2];						//!< \ingroup PIPES Output EKF state to SV Sel
 EXTERN int32 PVT_2_SVS_P[2];						//!< \ingroup PIPES Output PVT state to SV Select
 EXTERN int32 TLM_2_CMD_P[2];						//!< \ingroup PIPES Output received commands to Commando
 EXTERN int32 SVS_2_ACQ_P[2];						//!< \ingroup PIPES Request an acquisition because some of the channels are empty
-EXTERN int32 COR_2_ACQ_P[2];						//!< \ingroup PIPES Output packets of IF data to the Acquisition
 EXTERN int32 ISRP_2_PVT_P[2];						//!< \ingroup PIPES Output measurement preamble to PVT
 EXTERN int32 ISRM_2_PVT_P[2];						//!< \ingroup PIPES Output measurements to PVT
 /*----------------------------------------------------------------------------------------------*/
@@ -122,6 +122,26 @@ typedef struct Board_Health_M
 	uint32 sram_bad_hi;		//!< Debug info from Steve's POST
 	uint32 sram_bad_lo;		//!< Debug info from Steve's POST
 	uint32 adc_values[SHU_SIGNALS]; //!< A/D values from SHU
+	uint32 agc_hist0[AGC_HIST_BINS];	//!< Sample magnitude histogram, antenna 0
+	uint32 agc_hist1[AGC_HIST_BINS];	//!< Sample magnitude histogram, antenna 1
+	uint32 rec_ms;			//!< Ms of IF data recorded
+	uint32 rec_drops;		//!< Ms of IF data the recorder lost
+	uint32 rec_latency;		//!< Time of the recorder's last write (us)
+	uint32 rec_latency_max;	//!< Longest write by the recorder (us)
+	uint32 usb_blocks;		//!< USB blocks received
+	uint32 usb_overruns;	//!< USB blocks lost because the sample ring was full
+	uint32 usb_errors;		//!< Failed USB reads
+	uint32 fifo_depth;		//!< Size of the FIFO (ms)
+	uint32 fifo_fill;		//!< Packets held by the slowest lossless reader
+	uint32 fifo_fill_hi;	//!< High water mark of fifo_fill over the last second
+	uint32 fifo_fill_lo;	//!< Low water mark of fifo_fill over the last second
+	uint32 fifo_huge;		//!< 2 on huge pages, 1 on transparent huge pages, 0 on small pages
+	uint32 load_level;		//!< Overload level, 0 when keeping up
+	uint32 load_cap;		//!< Channels the overload controller allows
+	uint32 load_util;		//!< Smoothed correlation time per ms (us)
+	uint32 load_sheds;		//!< Channels dropped by the overload controller
+	uint32 trace_records;	//!< Channel trace records written (-c)
+	uint32 trace_drops;		//!< Channel trace records lost to full rings
 	uint32 tic;				//!< Global_tic associated with this data
 
 } Board_Health_M;
@@ -167,6 +187,7 @@ typedef struct Channel_M
 	int32 count;		//!< Number of accumulations that have been processed
 	int32 subframe;		//!< Current subframe number
 	int32 best_epoch;	//!< Best estimate of bit edge position
+	int32 pull_in;		//!< ms from channel start to frequency lock, -1 until locked
 
 
 	int32 l2_Mode;	 	//!< L2 Channel Flag
@@ -52,11 +52,14 @@ void wipeoff_gen(MIX *_dest, double _f, double _fs, int32 _samps);
 void downsample(CPX *_dest, CPX *_source, double _fdest, double _fsource, int32 _samps);
 void init_agc(CPX *_buff, int32 _samps, int32 bits, int32 *scale);
 int32 run_agc(CPX *_buff, int32 _samps, int32 bits, int32 scale);
+void agc_hist(CPX *_buff, int32 _samps, int32 _bits, uint32 *_hist);
 int32 AtanApprox(int32 y, int32 x);
 int32 Atan2Approx(int32 y, int32 x);
 int32 Invert4x4(double A[4][4], double B[4][4]);
 void FormCCSDSPacketHeader(CCSDS_Packet_Header *_p, uint32 _apid, uint32 _sf, uint32 _pl, uint32 _cm, uint32 _tic);
 void DecodeCCSDSPacketHeader(CCSDS_Decoded_Header *_d, CCSDS_Packet_Header *_p);
 uint32 adler(uint8 *data, int32 len);
+bool gps_parity(uint32 _word);
+uint32 gps_preamble(uint32 *_bits, int32 _words, uint32 _first);
 /*----------------------------------------------------------------------------------------------*/
 
@@ -71,7 +71,7 @@ typedef struct _Options_S
 	int32 	log_channel;	//!< Log low-level tracking loop info
 	int32	mode;			//!< Run in a  2 antenna mode with 2 DBS-RXs, Run in a  2 antenna mode, board A L1, board B L2
 	int32	decimate;
-	int32	realtime;
+	int32	realtime;		//!< 0 runs off the sample clock (post-processing a file as fast as possible)
 	int32	tlm_type;		//!< Telemetry type (named pipe/serial)
 	int32	source;			//!< GPS data source type
 	double	f_lo_a;			//!< LO freq for board A
@@ -82,23 +82,31 @@ typedef struct _Options_S
 	double 	gi;				//!< IF gain
 	double 	gr;				//!< RF gain
 	double	f_sample;		//!< Sample rate (depending on the clock)
+	float	acq_pnr;		//!< Strong acquisition stops once a peak clears this peak-to-noise ratio (0 for full search)
 	int32 	recorder;	
+	int32	record_bits;	//!< Record at this many bits per I or Q, 2, 4, 8, or 16
+	double	file_offset;	//!< Start playback this many seconds into the file(s)
+	double	file_duration;	//!< Stop the receiver after playing this many seconds, 0 to loop the whole file
+	double	file_pace;		//!< Play back at this multiple of real time, 0 for as fast as possible
+	int32	gn3s_sim;		//!< Simulate the GN3S instead of opening the hardware
+	int32	usb_blocks;		//!< Depth of the GN3S sample ring in USB blocks
+	int32	fifo_depth;		//!< Depth of the FIFO (ms)
 	char	file_name_1[1000];
 	char	file_name_2[1000]; // max out file name at 1000 chars.
+	char	stream_spec[1000];	//!< Pluggable source, see Sample_Source::Make
 
 
 } Options_S;
 /*----------------------------------------------------------------------------------------------*/
 
 
-//!< FIFO structure for linked list?
 /*----------------------------------------------------------------------------------------------*/
 /*! \ingroup STRUCTS
- *  @brief linked list structure for circular FIFO buffer */
+ *  @brief Slot of the circular FIFO buffer */
 typedef struct ms_packet {
 
-	ms_packet *next;
 	int32 count;					//!< Number of packets
+	CPX *payload[MAX_ANTENNAS];		//!< Where each antenna's samples are, either data[] or a file mapping
 	CPX data[MAX_ANTENNAS][SAMPS_MS];				//!< Payload size
 
 } ms_packet;
@@ -117,6 +125,7 @@ typedef struct _NCO_Command
 	uint32 kill;			//!< Stop or start the channel
 	uint32 reset_1ms;	//!< Reset the 1ms counter
 	uint32 reset_20ms;	//!< Reset the 20ms counter
+	uint32 _20ms_epoch;	//!< to this value
 	uint32 set_z_count;	//!< Set the z count
 	uint32 z_count;		//!< Actual value
 	uint32 length;		//!< Integrate for this many ms
@@ -169,45 +178,34 @@ typedef struct _Correlator_State_S
 
 
 /*! \ingroup STRUCTS
- * @brief State of phase lock loop */
-typedef struct _Phase_lock_loop {
-
-	float PLLBW;				//!< PLL Bandwidth (Hz)
-	float FLLBW;				//!< FLL Bandwidth (Hz)
-	float a3;
-	float b3;
-	float w0p;
-	float w0p2;
-	float w0p3;
-	float a2;
-	float w0f;
-	float w0f2;
-	float gain;
-	float w;					//!< Acceleration accumulator
-	float x;					//!< Velocity accumulator
-	float z;					//!< P feedback
-	float pll_lock;				//!< PLL Lock Indicator
-	float fll_lock;				//!< FLL lock indicator
-	float t;					//!< Integration length (ms)
-	int32 fll_lock_ticks;		//!< Is the fll locked?
-
-} Phase_lock_loop;
-
-
-/*! \ingroup STRUCTS
- * @brief State of delay lock loop */
-typedef struct _Delay_lock_loop
+ * @brief Tracking loops of 4 channels, channel n lives in lane n%4 of block n/4. Every field is one
+ * SSE register wide so sse_loops() can close the loops of 4 channels at once. The layout (16 bytes
+ * per field, in this order) is hard coded in sse_loops(), keep them in step. */
+typedef struct Loop_Block_S
 {
 
-	float DLLBW;				//!< Bandwidth
-	float x;					//!< Velocity accumulator
-	float z;					//!< Proportional feedback
-	float a;					//!< Acceleration accumulator
-	float w0;					//!< w0
-	float w02;					//!< w0^2
-	float t;					//!< Integration length
-
-} Delay_lock_loop;
+	/* Inputs, loaded by each channel that dumped this ms */
+	float ip[4];				//!< Prompt I
+	float qp[4];				//!< Prompt Q
+	float pe[4];				//!< Early power
+	float pl[4];				//!< Late power
+	int32 pll[4];				//!< -1 to run the PLL (once FrequencyLock() has pulled in)
+	int32 pull[4];				//!< -1 to pull the code in instead of running the DLL
+	int32 load[4];				//!< -1 if the channel dumped, cleared by the update
+
+	/* 3rd order PLL coefficients */
+	float kw[4];				//!< t*w0p^3
+	float kx[4];				//!< t*a3*w0p^2
+	float kz[4];				//!< b3*w0p
+	float kh[4];				//!< t/2
+
+	/* State */
+	float w[4];					//!< Acceleration accumulator
+	float x[4];					//!< Velocity accumulator (2x Doppler)
+	float z[4];					//!< Carrier NCO offset from the IF
+	float code[4];				//!< Code NCO offset from CODE_RATE
+
+} Loop_Block_S;
 /*----------------------------------------------------------------------------------------------*/
 
 #endif
@@ -161,6 +161,11 @@ typedef struct Acq_Command_S
 	int32 	accum_len;				//!< 1 or 20 ms
 	int32 	initial_state;			//!< Bit lock, etc etc
 
+	/* Scheduling */
+	int32	budget;					//!< Compute budget in ms before the search yields, 0 for none
+	int32	cursor;					//!< Doppler cell to resume the search from, 0 for a fresh search
+	int32	partial;				//!< Search was preempted, the result is the best-so-far
+
 } Acq_Command_S;
 
 
@@ -190,6 +195,7 @@ typedef struct SV_Select_Config_S
 	int32 weak_operation;			//!< 0 for off, 1 for warm only, 2 for warm and cold
 	int32 strong_operation;			//!< 0 for off, 1 for warm only, 2 for warm and cold
 	int32 weak_modulo;				//!< This many weaks per 32 strong
+	int32 weak_budget;				//!< A weak acquisition yields to strong ones after this many ms, 0 for never
 
 } SV_Select_Config_S;
 
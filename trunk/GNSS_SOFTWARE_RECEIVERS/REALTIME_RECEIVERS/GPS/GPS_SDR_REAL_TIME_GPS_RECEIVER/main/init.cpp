@@ -40,6 +40,9 @@
 #include "sv_select.h"			//!< Drives acquisition/reacquisition process
 #include "gps_source.h"			//!< Get GPS IF data from where?
 #include "patience.h"
+#include "recorder.h"			//!< Record the IF data
+#include "overload.h"			//!< Load shedding
+#include "tracer.h"			//!< Channel trace
 /*----------------------------------------------------------------------------------------------*/
 
 
@@ -60,9 +63,20 @@ void usage(char *_str)
 	fprintf(stdout,"[-x] the USRP samples at a modified 65.536 MHz (default is 64 MHz)\n");
 	fprintf(stdout,"[-s] output over /dev/ttyS0 instead of the named pipe\n");
 	fprintf(stdout,"[-gn3s] use the SIGE GN3S sampling device\n");
+	fprintf(stdout,"[-gn3s_sim] simulate the GN3S, paced by -pace (0 never drops a block)\n");
+	fprintf(stdout,"[-ub] <blocks> depth of the GN3S sample ring in 16 KB USB blocks (default %d)\n",GN3S_RING_BLOCKS);
 	fprintf(stdout,"[-p] <file1> use data files as 1 sampling devices\n"); 	
 	fprintf(stdout,"[-f] <file1> <file2> use data files as 2 sampling devices\n"); 
+	fprintf(stdout,"[-fifo] <ms> depth of the sample FIFO, %d to %d (default %d)\n",FIFO_MIN_DEPTH,FILE_WINDOW_MS-1,FIFO_DEPTH);
+	fprintf(stdout,"[-in] <source> read samples from tcp:<host>:<port>, udp:[<host>:]<port>, a named pipe, or - for stdin\n");
+	fprintf(stdout,"       sim:<satellites>[:<C/N0>] or sim:<scenario file> synthesizes the IF, paced by -pace\n");
 	fprintf(stdout,"[-r] record sampled data as well as tracking\n");
+	fprintf(stdout,"[-rb] <bits> record packed to 2, 4, or 8 bits per I or Q (default 16)\n");
+	fprintf(stdout,"[-o] <seconds> start file playback this far into the file(s)\n");
+	fprintf(stdout,"[-d] <seconds> stop after playing this much of the file(s) (default loops the whole file)\n");
+	fprintf(stdout,"[-pace] <rate> play files at this multiple of real time, 0 is as fast as possible (default 1)\n");
+	fprintf(stdout,"[-post] post-process the file(s) as fast as possible, reproducibly, off the sample clock\n");
+	fprintf(stdout,"[-t] <ratio> stop a strong acquisition at this peak-to-noise ratio (0 searches all Dopplers)\n");
 	fflush(stdout);
 	exit(1);
 }
@@ -81,6 +95,24 @@ void echo_options()
 		fprintf(stdout,"Verbose:          %13d\n",gopt.verbose);
 		fprintf(stdout,"Log channel:      %13d\n",gopt.log_channel);
 		fprintf(stdout,"Telemetry:        %13d\n",gopt.tlm_type);
+		fprintf(stdout,"Acq PNR:          %13.2f\n",gopt.acq_pnr);
+		fprintf(stdout,"Realtime:         %13d\n",gopt.realtime);
+		fprintf(stdout,"FIFO Depth:       %13d\n",gopt.fifo_depth);
+		if(gopt.recorder)
+			fprintf(stdout,"Record Bits:      %13d\n",gopt.record_bits);
+		if(gopt.source == SOURCE_FILE)
+		{
+			fprintf(stdout,"File Offset:      %13.2f\n",gopt.file_offset);
+			fprintf(stdout,"File Duration:    %13.2f\n",gopt.file_duration);
+			fprintf(stdout,"File Pace:        %13.2f\n",gopt.file_pace);
+		}
+		if(gopt.source == SOURCE_STREAM)
+			fprintf(stdout,"Sample Source:    %13s\n",gopt.stream_spec);
+		if(gopt.source == SOURCE_SIGE_GN3S)
+		{
+			fprintf(stdout,"GN3S Simulated:   %13d\n",gopt.gn3s_sim);
+			fprintf(stdout,"USB Blocks:       %13d\n",gopt.usb_blocks);
+		}
 		if(gopt.source != SOURCE_SIGE_GN3S)
 		{
 			fprintf(stdout,"USRP Decimation:  %13d\n",gopt.decimate);
@@ -125,6 +157,14 @@ void Parse_Arguments(int32 argc, char* argv[])
 	gopt.realtime		= 1;
 	gopt.source			= SOURCE_USRP_V1;
 	gopt.recorder = 0;
+	gopt.record_bits	= 16;		//!< Raw CPX
+	gopt.acq_pnr		= THRESH_STRONG_PNR;
+	gopt.file_offset	= 0;		//!< Start of the file
+	gopt.file_duration	= 0;		//!< Loop the whole file
+	gopt.file_pace		= 1.0;		//!< Real time
+	gopt.gn3s_sim		= 0;
+	gopt.usb_blocks		= GN3S_RING_BLOCKS;
+	gopt.fifo_depth		= FIFO_DEPTH;
 
 	for(lcv = 1; lcv < argc; lcv++)
 	{
@@ -164,6 +204,11 @@ void Parse_Arguments(int32 argc, char* argv[])
 				{
 					gopt.source	= SOURCE_SIGE_GN3S;
 				}
+				else if(strcmp(argv[lcv], "-gn3s_sim") == 0)
+				{
+					gopt.source	= SOURCE_SIGE_GN3S;
+					gopt.gn3s_sim = 1;
+				}
 				else
 					usage(argv[0]);
 				break;
@@ -187,11 +232,44 @@ void Parse_Arguments(int32 argc, char* argv[])
 			case 'x':
 				gopt.f_sample = 65.536e6;
 				break;
+			case 'i':
+				if(strcmp(argv[lcv], "-in") != 0)
+					usage (argv[0]);
+
+				if(++lcv >= argc)
+					usage (argv[0]);
+
+				gopt.source	= SOURCE_STREAM;
+				strncpy(gopt.stream_spec, argv[lcv], 999);
+				gopt.stream_spec[999] = '\0';
+				break;
+			case 'u':
+				if(strcmp(argv[lcv], "-ub") != 0)
+					usage (argv[0]);
+
+				if(++lcv >= argc)
+					usage (argv[0]);
+
+				gopt.usb_blocks = atoi(argv[lcv]);
+				if(gopt.usb_blocks < 2)
+					usage (argv[0]);
+				break;
 			case 's':
 				gopt.tlm_type = TELEM_SERIAL;
 				break;
 
 			case 'f':
+				if(strcmp(argv[lcv], "-fifo") == 0)
+				{
+					if(++lcv >= argc)
+						usage (argv[0]);
+
+					gopt.fifo_depth = atoi(argv[lcv]);
+					if((gopt.fifo_depth < FIFO_MIN_DEPTH) || (gopt.fifo_depth >= FILE_WINDOW_MS))
+						usage (argv[0]);
+					break;
+				}
+
 				gopt.source	= SOURCE_FILE;
 				if(argc < lcv+3)
 				usage (argv[0]);
@@ -201,6 +279,25 @@ void Parse_Arguments(int32 argc, char* argv[])
 				lcv += 2;
 				break;
 			case 'p':
+				if(strcmp(argv[lcv], "-post") == 0)
+				{
+					gopt.realtime = 0;
+					gopt.file_pace = 0;
+					break;
+				}
+
+				if(strcmp(argv[lcv], "-pace") == 0)
+				{
+					if(++lcv >= argc)
+						usage (argv[0]);
+
+					if(isdigit(argv[lcv][0]))
+						gopt.file_pace = strtod(argv[lcv], &parse);
+					else
+						usage (argv[0]);
+					break;
+				}
+
 				gopt.source	= SOURCE_FILE;
 				if(argc < lcv+2)
 				usage (argv[0]);
@@ -211,6 +308,43 @@ void Parse_Arguments(int32 argc, char* argv[])
 				break;
 			case 'r':
 				gopt.recorder=1;
+
+				if(strcmp(argv[lcv], "-rb") == 0)
+				{
+					if(++lcv >= argc)
+						usage (argv[0]);
+
+					gopt.record_bits = atoi(argv[lcv]);
+					if((gopt.record_bits != 2) && (gopt.record_bits != 4) && (gopt.record_bits != 8) && (gopt.record_bits != 16))
+						usage (argv[0]);
+				}
+				break;
+			case 'o':
+				if(++lcv >= argc)
+					usage (argv[0]);
+
+				if(isdigit(argv[lcv][0]))
+					gopt.file_offset = strtod(argv[lcv], &parse);
+				else
+					usage (argv[0]);
+				break;
+			case 'd':
+				if(++lcv >= argc)
+					usage (argv[0]);
+
+				if(isdigit(argv[lcv][0]))
+					gopt.file_duration = strtod(argv[lcv], &parse);
+				else
+					usage (argv[0]);
+				break;
+			case 't':
+				if(++lcv >= argc)
+					usage (argv[0]);
+
+				if(isdigit(argv[lcv][0]))
+					gopt.acq_pnr = strtod(argv[lcv], &parse);
+				else
+					usage (argv[0]);
 				break;
 
 
@@ -219,6 +353,10 @@ void Parse_Arguments(int32 argc, char* argv[])
 		}
 	}
 
+	/* Only a file or a stream can be run off the sample clock */
+	if(!gopt.realtime && (gopt.source != SOURCE_FILE) && (gopt.source != SOURCE_STREAM))
+		usage(argv[0]);
+
 	echo_options();
 
 }
@@ -292,6 +430,8 @@ int32 Object_Init(void)
 
 	/* Get start of receiver */
 	gettimeofday(&starttime, NULL);
+	gclock = 0;
+	gsubframes = 0;
 
 	/* Create Keyboard object to handle user input */
 	pKeyboard = new Keyboard();
@@ -317,7 +457,13 @@ int32 Object_Init(void)
 	/* Form a nav solution */
 	pPVT = new PVT();
 
-	/* Create the tracking channels */
+	/* Trace the channels */
+	pTracer = NULL;
+	if(gopt.log_channel)
+		pTracer = new Tracer();
+
+	/* Create the tracking channels, and the loops they share */
+	pLoops = new Loop_Bank;
 	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
 		pChannels[lcv] = new Channel(lcv);
 
@@ -327,8 +473,16 @@ int32 Object_Init(void)
 	/* Startup Watchdog */
 	pPatience = new Patience;
 
+	/* Shed load if the correlator falls behind */
+	pOverload = new Overload;
+
 	pCorrelator = new Correlator();
 
+	/* Record the IF data off the FIFO */
+	pRecorder = NULL;
+	if(gopt.recorder && (gopt.source != SOURCE_FILE))
+		pRecorder = new Recorder();
+
 	if(gopt.verbose)
 	{
 		fprintf(stdout,"Cleared Object Init\n");
@@ -359,12 +513,10 @@ int32 Pipes_Init(void)
 	pipe((int *)PVT_2_SVS_P);
 	pipe((int *)TLM_2_CMD_P);
 	pipe((int *)SVS_2_ACQ_P);
-	pipe((int *)COR_2_ACQ_P);
 	pipe((int *)ISRP_2_PVT_P);
 	pipe((int *)ISRM_2_PVT_P);
 
 	/* Setup some of the non-blocking pipes */
-	fcntl(COR_2_ACQ_P[WRITE], F_SETFL, O_NONBLOCK);
 	fcntl(EKF_2_SVS_P[WRITE], F_SETFL, O_NONBLOCK);
 	fcntl(SVS_2_TLM_P[WRITE], F_SETFL, O_NONBLOCK);
 	fcntl(PVT_2_SVS_P[WRITE], F_SETFL, O_NONBLOCK);
@@ -421,6 +573,14 @@ int32 Thread_Init(void)
 	/* Last thing to do */
 	pTelemetry->Start();
 
+	/* Start draining the channel trace */
+	if(pTracer != NULL)
+		pTracer->Start();
+
+	/* Start up the recorder before the data starts flowing */
+	if(pRecorder != NULL)
+		pRecorder->Start();
+
 	/* Start up the FIFO */
 	pFIFO->Start();
 
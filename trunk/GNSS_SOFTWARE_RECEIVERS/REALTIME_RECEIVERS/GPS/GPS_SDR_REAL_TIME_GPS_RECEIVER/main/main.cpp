@@ -37,6 +37,8 @@ int main(int argc, char* argv[])
 	int fin[2];
 	int fout[2];
 	pid_t pid;
+	struct timeval now;
+	double wall;
 
 	Parse_Arguments(argc, argv);
 
@@ -92,6 +94,15 @@ int main(int argc, char* argv[])
 		usleep(10000);
 	}
 
+	/* Report how much faster than the sampler we went */
+	if(!gopt.realtime)
+	{
+		gettimeofday(&now, NULL);
+		wall = (double)(now.tv_sec - starttime.tv_sec) + 1e-6*(double)(now.tv_usec - starttime.tv_usec);
+		fprintf(stdout,"Processed %.3f s of data in %.3f s, %.2fx real time\n",
+			(double)gclock*.001, wall, (wall > 0) ? (double)gclock*.001/wall : 0);
+	}
+
 	Thread_Shutdown();
 
 	Pipes_Shutdown();
@@ -40,6 +40,9 @@
 #include "sv_select.h"			//!< Drives acquisition/reacquisition process
 #include "gps_source.h"			//!< Get GPS data
 #include "patience.h"
+#include "recorder.h"			//!< Record the IF data
+#include "overload.h"			//!< Load shedding
+#include "tracer.h"			//!< Channel trace
 /*----------------------------------------------------------------------------------------------*/
 
 
@@ -57,6 +60,14 @@ void Thread_Shutdown(void)
 	/* Stop the FIFO */
 	pFIFO->Stop();
 
+	/* Stop the recorder */
+	if(pRecorder != NULL)
+		pRecorder->Stop();
+
+	/* Stop draining the channel trace, the destructor gets the rest */
+	if(pTracer != NULL)
+		pTracer->Stop();
+
 	/* Stop the telemetry */
 	pTelemetry->Stop();
 
@@ -66,7 +77,8 @@ void Thread_Shutdown(void)
 	/* Stop the correlator */
 	pCorrelator->Stop();
 
-	/* Stop the acquistion */
+	/* Stop the acquistion, abandoning any search in progress */
+	pAcquisition->Cancel();
 	pAcquisition->Stop();
 
 	/* Stop the ephemeris */
@@ -98,7 +110,6 @@ void Pipes_Shutdown(void)
 	close(PVT_2_SVS_P[READ]);
 	close(TLM_2_CMD_P[READ]);
 	close(SVS_2_ACQ_P[READ]);
-	close(COR_2_ACQ_P[READ]);
 	close(ISRP_2_PVT_P[READ]);
 	close(ISRM_2_PVT_P[READ]);
 
@@ -113,7 +124,6 @@ void Pipes_Shutdown(void)
 	close(PVT_2_SVS_P[WRITE]);
 	close(TLM_2_CMD_P[WRITE]);
 	close(SVS_2_ACQ_P[WRITE]);
-	close(COR_2_ACQ_P[WRITE]);
 	close(ISRP_2_PVT_P[WRITE]);
 	close(ISRM_2_PVT_P[WRITE]);
 
@@ -132,7 +142,11 @@ void Object_Shutdown(void)
 	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
 		delete pChannels[lcv];
 
+	delete pLoops;
+	delete pTracer;
+
 	delete pKeyboard;
+	delete pRecorder;
 	delete pAcquisition;
 	delete pEphemeris;
 	delete pFIFO;
@@ -141,6 +155,7 @@ void Object_Shutdown(void)
 	delete pPVT;
 	delete pCommando;
 	delete pPatience;
+	delete pOverload;
 
 }
 /*----------------------------------------------------------------------------------------------*/
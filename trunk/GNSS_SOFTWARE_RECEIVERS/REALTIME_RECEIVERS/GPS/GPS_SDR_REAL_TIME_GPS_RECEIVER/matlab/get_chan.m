@@ -1,32 +1,42 @@
 function [A] = get_chan(chan)
 
-% uint32 tic;			//!< Corresponds to this receiver tic
-% int32 chan;			//!< The channel number
-% int32 sv;			//!< SV/PRN number the channel is tracking
-% int32 state;		//!< channel's state
-% int32 antenna;		//!< Antenna channel is tracking off of
-% int32 len;			//!< acummulation length (1 or 20 ms)
-% int32 w;			//!< 3rd order PLL state
-% int32 x;			//!< 3rd order PLL state
-% int32 z;			//!< 3rd order PLL state
-% int32 code_nco;		//!< State of code_nco
-% int32 carrier_nco;	//!< State of carrier_nco
-% int32 cn0;			//!< CN0 estimate
-% int32 p_avg;		//!< Filtered version of I^2+Q^2
-% int32 bit_lock;		//!< Bit lock?
-% int32 frame_lock;	//!< Frame lock?
-% int32 navigate;		//!< Navigate on this channel flag
-% int32 count;		//!< Number of accumulations that have been processed
-% int32 subframe;		//!< Current subframe number
-% int32 best_epoch;	//!< Best estimate of bit edge position
+% GET_CHAN Read the trace of a tracking channel
+%   A = GET_CHAN(chan) converts the receiver's binary channel trace (-c option,
+%   ../channels.trc) with gps-trace and returns one row per dump:
+%
+% 1  tic			FIFO count of the ms the dump was made on
+% 2  chan			The channel number
+% 3  sv				SV/PRN number the channel is tracking (0 based)
+% 4  state			channel's state
+% 5  antenna		Antenna channel is tracking off of
+% 6  len			acummulation length (1 or 20 ms)
+% 7  count			Number of accumulations that have been processed
+% 8  I_early		Early, prompt, late inphase correlations
+% 9  I_prompt
+% 10 I_late
+% 11 Q_early		Early, prompt, late quadrature correlations
+% 12 Q_prompt
+% 13 Q_late
+% 14 carrier_nco	Carrier NCO (Hz)
+% 15 code_nco		Code NCO (chips/s)
+% 16 cn0			CN0 estimate (dB-Hz)
+% 17 p_avg			Filtered version of I^2+Q^2
+% 18 w				3rd order PLL state
+% 19 x				3rd order PLL state
+% 20 z				3rd order PLL state
+% 21 bit_lock		Bit lock?
+% 22 frame_lock		Frame lock?
+% 23 freq_lock		Frequency lock?
+% 24 navigate		Navigate on this channel flag
+% 25 subframe		Current subframe number
+% 26 best_epoch		Best estimate of bit edge position
+% 27 pull_in		ms from channel start to frequency lock, -1 until locked
 
+fname = sprintf('../chan%02d.csv',chan);
 
-pts = 19+6+20;
+str = sprintf('../gps-trace -c %d ../channels.trc > %s',chan,fname);
+if(system(str) ~= 0)
+    error('gps-trace could not convert ../channels.trc');
+end
 
-fp = fopen(sprintf('../chan%02d.dat',chan),'rb');
-A(:,1) = fread(fp,inf,'int32'); 
-
-len = floor(length(A)/pts);
-A = A(1:len*pts);
-
-A = reshape(A, [pts len]).';
\ No newline at end of file
+A = csvread(fname,1,0);
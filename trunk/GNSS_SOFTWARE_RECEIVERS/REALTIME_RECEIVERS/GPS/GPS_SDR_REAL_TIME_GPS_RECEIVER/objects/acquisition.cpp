@@ -26,7 +26,6 @@
 /*----------------------------------------------------------------------------------------------*/
 
 #include "acquisition.h"
-#include "prn_codes.h"	//!< Include the pre-fftd PRN codes (done with MATLAB)
 
 //#define ACQ_DEBUG
 
@@ -73,9 +72,12 @@ Acquisition::Acquisition(float _fsample, float _fif):Threaded_Object("ACQTASK")
 	CPX *p;
 	int32 R1[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 	int32 R2[16] = {0,0,0,0,0,0,0,1,0,1,0,1,1,1,1,1};
+	int32 R3[16] = {0,0,0,0,0,0,0,1,0,0,1,1,1,1,1,1};	/* The fold already scales by 1/2 */
 
 	/* Acq state */
 	sv = 0;
+	cancel = false;
+	busy = false;
 	state = ACQ_TYPE_STRONG;
 
 	/* Grab some constants */
@@ -87,9 +89,10 @@ Acquisition::Acquisition(float _fsample, float _fif):Threaded_Object("ACQTASK")
 	/* Resample to the nearest 2^N */
 	resamps_ms = SAMPS_MS; //Always decimate to 2048 samples/ms for C/A code
 
-	/* Step one, grab pre-fftd codes from header file */
+	/* Step one, map (or generate) the pre-fftd codes */
+	pCodes = new Code_Cache((int32)fbase, resamps_ms);
 	for(lcv = 0; lcv < MAX_SV; lcv++)
-		fft_codes[lcv] = (CPX *)&PRN_Codes[2*lcv*resamps_ms];
+		fft_codes[lcv] = pCodes->getCode(lcv);
 
 	/* Allocate some buffers that will be used later on */
 	buff	 = new CPX[310 * resamps_ms];
@@ -103,6 +106,13 @@ Acquisition::Acquisition(float _fsample, float _fif):Threaded_Object("ACQTASK")
 	_500Hzwipeoff = new CPX[310 * resamps_ms];
 	_750Hzwipeoff = new CPX[310 * resamps_ms];
 
+	/* Fine Doppler stage */
+	fine_bins = 2*(int32)(500.0/ACQ_FINE_STEP) + 1;
+	strong_pnr = 0;
+	fine_i = new double[ACQ_FINE_MS + 1];
+	fine_q = new double[ACQ_FINE_MS + 1];
+	fine_spectrum = new double[fine_bins];
+
 	/* Allocate baseband shift vector and map of the row pointers */
 	baseband_shift = new CPX[4 * 310 * (resamps_ms+201)];
 	baseband_rows = new CPX *[1240];
@@ -139,6 +149,7 @@ Acquisition::Acquisition(float _fsample, float _fif):Threaded_Object("ACQTASK")
 	/* Allocate the FFTs */
 	pFFT = new FFT(resamps_ms, R1);
 	piFFT = new FFT(resamps_ms, R2);
+	pdFFT = new FFT(resamps_ms/2, R3);
 	pcFFT = new FFT(32);
 
 	if(gopt.verbose)
@@ -159,7 +170,9 @@ Acquisition::~Acquisition()
 
 	delete pFFT;
 	delete piFFT;
+	delete pdFFT;
 	delete pcFFT;
+	delete pCodes;
 
 	delete [] buff;
 	delete [] rotate;
@@ -175,6 +188,9 @@ Acquisition::~Acquisition()
 	delete [] _250Hzwipeoff;
 	delete [] _500Hzwipeoff;
 	delete [] _750Hzwipeoff;
+	delete [] fine_i;
+	delete [] fine_q;
+	delete [] fine_spectrum;
 
 	if(gopt.verbose)
 		fprintf(stdout,"Destructing Acquisition\n");
@@ -239,52 +255,144 @@ void Acquisition::doPrepIF(int32 _type, CPX *_buff)
 
 /*----------------------------------------------------------------------------------------------*/
 /*!
- * doAcqStrong: Acquire using a 1 ms coherent integration
+ * doAcqStrong: Acquire using a 1 ms coherent integration. The 250 Hz Doppler cells are visited
+ * starting at _doppcen and spiraling outward, the search stops early once a peak clears the
+ * peak-to-noise ratio in gopt.acq_pnr (0 sweeps the entire range).
+ *
+ * The search is done in two stages. Folding the 2048 point product spectrum in half and taking a
+ * 1024 point iFFT yields exactly the even lags of the full correlation (~1 chip spacing), which is
+ * plenty for detection. Only the winning cell is then recomputed at full resolution to pin down
+ * the code phase.
  * */
-Acq_Command_S Acquisition::doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax)
+Acq_Command_S Acquisition::doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax, int32 _doppcen)
 {
 
-	FILE *fp;
-	int32 lcv, lcv2, mag, magt, index, indext;
+	int32 lcv, lcv2, mag, magt, index, indext, half;
+	int32 cell, cmin, cmax, ccen, step, best, steps;
+	int64 noise;
 	Acq_Command_S *result = &results[_sv];
-	CPX *p;
 
 	index = indext = mag = magt = 0;
+	half = resamps_ms >> 1;
+
+	/* Doppler cells in units of 250 Hz */
+	cmin = 4*(_doppmin/1000);
+	cmax = 4*(_doppmax/1000);
+	ccen = (int32)floor((float)_doppcen/250.0 + 0.5);
 
-	/* Covers the 250 Hz spacing */
-	for(lcv = (_doppmin/1000); lcv <  (_doppmax/1000); lcv++)
+	if(ccen < cmin)
+		ccen = cmin;
+	if(ccen >= cmax)
+		ccen = cmax - 1;
+
+	best = ccen;
+
+	/* Stage 1, spiral out from the center: 0, +1, -1, +2, -2, ... (resuming at the cursor) */
+	steps = 2*(cmax - cmin);
+	for(step = request.cursor; step < steps; step++)
 	{
-		/* Sweep through the doppler range */
-		for(lcv2 = 0; lcv2 < 4; lcv2 ++)
+		/* Out of time or cancelled, remember where to pick up */
+		if(Preempted())
 		{
+			result->cursor = step;
+			result->partial = 1;
+			break;
+		}
 
-			if(gopt.realtime)
-				usleep(1000);
+		if(step & 0x1)
+			cell = ccen + (step+1)/2;
+		else
+			cell = ccen - step/2;
 
-			/* Multiply in frequency domain, shifting appropriately */
-			sse_cmulsc(&baseband_rows[lcv2][100+lcv], fft_codes[_sv], msbuff, resamps_ms, 10);
+		if((cell < cmin) || (cell >= cmax))
+			continue;
 
-			/* Compute iFFT */
-			piFFT->doiFFT(msbuff, true);
+		/* 1 kHz shift of the rows and 250 Hz offset wipeoff */
+		lcv = (cell >= 0) ? (cell/4) : -((3-cell)/4);
+		lcv2 = cell - 4*lcv;
 
-			/* Convert to a power */
-			x86_cmag(msbuff, resamps_ms);
+		if(gopt.realtime)
+			usleep(1000*pOverload->getStretch());
 
-			/* Find the maximum */
-			x86_max((int32 *)msbuff, &indext, &magt, resamps_ms);
+		/* Multiply in frequency domain, shifting appropriately */
+		sse_cmulsc(&baseband_rows[lcv2][100+lcv], fft_codes[_sv], msbuff, resamps_ms, 10);
 
-			/* Found a new maximum */
-			if(magt > mag)
-			{
-				mag = magt;
-				index = indext;
-				//result->delay = CODE_CHIPS - (float)index*CODE_RATE/fbase;
-				result->code_phase = 2048 - index;
-				result->doppler = (lcv*1000) + (float)lcv2*250;
-				result->magnitude = mag;
-			}
+		/* Fold the spectrum, equivalent to decimating the correlation by 2 */
+		for(lcv = 0; lcv < half; lcv++)
+		{
+			msbuff[lcv].i = (msbuff[lcv].i + msbuff[lcv+half].i) >> 1;
+			msbuff[lcv].q = (msbuff[lcv].q + msbuff[lcv+half].q) >> 1;
+		}
+
+		/* Compute half length iFFT */
+		pdFFT->doiFFT(msbuff, true);
+
+		/* Convert to a power */
+		x86_cmag(msbuff, half);
 
+		/* Find the maximum */
+		x86_max((int32 *)msbuff, &indext, &magt, half);
+
+		/* Found a new maximum */
+		if(magt > mag)
+		{
+			mag = magt;
+			index = indext;
+			best = cell;
 		}
+
+		/* Stop as soon as the peak clears the noise floor by enough */
+		if(gopt.acq_pnr > 0)
+		{
+			noise = 0;
+			for(lcv = 0; lcv < half; lcv++)
+				noise += ((int32 *)msbuff)[lcv];
+
+			noise = (noise - magt)/(half - 1);
+
+			if((noise > 0) && ((float)magt > gopt.acq_pnr*(float)noise))
+				break;
+		}
+	}
+
+	/* Stage 2, redo the winning cell at full resolution around the coarse lag */
+	lcv = (best >= 0) ? (best/4) : -((3-best)/4);
+	lcv2 = best - 4*lcv;
+
+	sse_cmulsc(&baseband_rows[lcv2][100+lcv], fft_codes[_sv], msbuff, resamps_ms, 10);
+	piFFT->doiFFT(msbuff, true);
+	x86_cmag(msbuff, resamps_ms);
+
+	mag = 0; indext = 2*index;
+	for(step = -2; step <= 2; step++)
+	{
+		cell = (2*index + step + resamps_ms) % resamps_ms;
+		magt = ((int32 *)msbuff)[cell];
+		if(magt > mag)
+		{
+			mag = magt;
+			indext = cell;
+		}
+	}
+
+	/* A resumed search only replaces the best-so-far of the earlier slices if it beats it */
+	if((request.cursor == 0) || (mag > (int32)result->magnitude))
+	{
+		//result->delay = CODE_CHIPS - (float)index*CODE_RATE/fbase;
+		result->code_phase = 2048 - indext;
+		result->doppler = (lcv*1000) + (float)lcv2*250;
+		result->magnitude = mag;
+		result->count = request.count;
+
+		/* Peak-to-noise of the winning cell, the correlation triangle is left out of the floor */
+		noise = 0;
+		for(lcv = 0; lcv < resamps_ms; lcv++)
+			noise += ((int32 *)msbuff)[lcv];
+		for(step = -2; step <= 2; step++)
+			noise -= ((int32 *)msbuff)[(indext + step + resamps_ms) % resamps_ms];
+		noise /= (resamps_ms - 5);
+
+		strong_pnr = (noise > 0) ? (float)mag/(float)noise : 0;
 	}
 
 	result->sv = _sv;
@@ -302,6 +410,129 @@ Acq_Command_S Acquisition::doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax
 /*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * doAcqFine: Refine the Doppler of a successful coarse acquisition over a fresh ACQ_FINE_MS snapshot,
+ * which stays pinned only while it is correlated. The prompt correlation is formed every ms at the coarse code phase, squared to strip the
+ * data bits, then a DFT is swept across the +-250 Hz (doubled) residual. On success the result is
+ * tagged ACQ_TYPE_FINE so the channel can skip its sliding DFT FrequencyLock().
+ * */
+Acq_Command_S Acquisition::doAcqFine(int32 _sv)
+{
+
+	Acq_Command_S *result = &results[_sv];
+	int32 lcv, lcv2, ms, index, indext, bins;
+	int64 mag, magt;
+	double f, phase, ti, tq, si, sq, wi, wq, acc_i, acc_q, pwr, ppwr, mpwr, den, delta;
+	double *prompt_i = fine_i;
+	double *prompt_q = fine_q;
+	double *spectrum = fine_spectrum;
+	CPX *p;
+
+	ms = ACQ_FINE_MS;
+	if((ms <= 0) || (result->success == 0) || result->partial)
+		return(results[_sv]);
+
+	/* Coarse carrier and code phase from the strong search, the code phase holds to within the
+	 * tracked +-3 samples over the few ms since the coarse snapshot */
+	f = -(fif + (double)result->doppler);
+	index = (resamps_ms - result->code_phase) % resamps_ms;
+
+	pFIFO->Snapshot(ms);
+
+	for(lcv = 0; lcv < ms; lcv++)
+	{
+		if(gopt.realtime && ((lcv & 0x7) == 0))
+			usleep(1000*pOverload->getStretch());
+
+		/* Continuous phase wipeoff of this ms */
+		phase = fmod(TWO_PI*f*(double)lcv*.001, TWO_PI);
+		sine_gen(rotate, f, SAMPLE_FREQUENCY, resamps_ms, phase);
+		sse_cmulsc(pFIFO->getSnapshot(lcv)->payload[0], rotate, msbuff, resamps_ms, 14);
+
+		/* Circular correlation against the code */
+		pFFT->doFFT(msbuff, true);
+		sse_cmuls(msbuff, fft_codes[_sv], resamps_ms, 10);
+		piFFT->doiFFT(msbuff, true);
+
+		/* The code drifts a few samples across the snapshot, track the peak */
+		mag = -1; indext = index;
+		for(lcv2 = -3; lcv2 <= 3; lcv2++)
+		{
+			p = &msbuff[(index + lcv2 + resamps_ms) % resamps_ms];
+			magt = (int64)p->i*(int64)p->i + (int64)p->q*(int64)p->q;
+			if(magt > mag)
+			{
+				mag = magt;
+				indext = (index + lcv2 + resamps_ms) % resamps_ms;
+			}
+		}
+
+		/* Frequency double to remove the data bits */
+		p = &msbuff[indext];
+		prompt_i[lcv] = (double)p->i*(double)p->i - (double)p->q*(double)p->q;
+		prompt_q[lcv] = 2.0*(double)p->i*(double)p->q;
+	}
+
+	pFIFO->Release();
+
+	/* Sweep the doubled residual in ACQ_FINE_STEP Hz steps */
+	bins = fine_bins;
+
+	mpwr = 0; ppwr = -1; indext = 0;
+	for(lcv2 = 0; lcv2 < bins; lcv2++)
+	{
+		f = -500.0 + (double)lcv2*ACQ_FINE_STEP;
+		wi = cos(TWO_PI*f*.001);
+		wq = -sin(TWO_PI*f*.001);
+
+		si = 1.0; sq = 0.0;
+		acc_i = acc_q = 0;
+		for(lcv = 0; lcv < ms; lcv++)
+		{
+			acc_i += prompt_i[lcv]*si - prompt_q[lcv]*sq;
+			acc_q += prompt_i[lcv]*sq + prompt_q[lcv]*si;
+
+			ti = si*wi - sq*wq;
+			tq = si*wq + sq*wi;
+			si = ti; sq = tq;
+		}
+
+		pwr = acc_i*acc_i + acc_q*acc_q;
+		spectrum[lcv2] = pwr;
+		mpwr += pwr;
+
+		if(pwr > ppwr)
+		{
+			ppwr = pwr;
+			indext = lcv2;
+		}
+	}
+	mpwr /= (double)bins;
+
+	/* Parabolic interpolation around the peak */
+	delta = 0;
+	if((indext > 0) && (indext < bins-1))
+	{
+		den = spectrum[indext-1] - 2.0*spectrum[indext] + spectrum[indext+1];
+		if(den != 0)
+			delta = 0.5*(spectrum[indext-1] - spectrum[indext+1])/den;
+	}
+
+	/* Accept only a clear peak, otherwise the channel falls back to its own frequency lock */
+	if(ppwr > ACQ_FINE_CONFIDENCE*mpwr)
+	{
+		f = -500.0 + ((double)indext + delta)*ACQ_FINE_STEP;
+		result->doppler += (int32)floor(f/2.0 + 0.5);
+		result->type = ACQ_TYPE_FINE;
+	}
+
+	return(results[_sv]);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
 /*----------------------------------------------------------------------------------------------*/
 /*!
  * doAcqMedium: Acquire using a 10 ms coherent integrationACQ_WEAK
@@ -309,7 +540,7 @@ Acq_Command_S Acquisition::doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax
 Acq_Command_S Acquisition::doAcqMedium(int32 _sv, int32 _doppmin, int32 _doppmax)
 {
 	Acq_Command_S *result;
-	int32 lcv, lcv2, lcv3, mag, magt, index, indext, j, k, dopp, skip;
+	int32 lcv, lcv2, lcv3, mag, magt, index, indext, j, k, dopp, skip, cell;
 	int32 iaccum, qaccum;
 	CPX temp[10];
 	int32 data[32];
@@ -320,19 +551,36 @@ Acq_Command_S Acquisition::doAcqMedium(int32 _sv, int32 _doppmin, int32 _doppmax
 	result = &results[_sv];
 	index = indext = mag = magt = 0;
 
+	/* Resuming, seed with the best-so-far */
+	if(request.cursor > 0)
+		mag = result->magnitude;
+
 	/* Sweeps through the doppler range */
-	for(lcv = (_doppmin/1000); lcv <=  (_doppmax/1000); lcv++)
+	for(lcv = (_doppmin/1000); (lcv <=  (_doppmax/1000)) && !result->partial; lcv++)
 	{
 		/* Covers the 250 Hz spacing */
 		for(lcv2 = 0; lcv2 < 4; lcv2++)
 		{
+			/* Skip what an earlier slice already searched */
+			cell = 4*(lcv - _doppmin/1000) + lcv2;
+			if(cell < request.cursor)
+				continue;
+
+			/* Out of time or cancelled, remember where to pick up */
+			if(Preempted())
+			{
+				result->cursor = cell;
+				result->partial = 1;
+				break;
+			}
+
 			/* Do both even and odd */
 			//for(k = 0; k < 2; k++)
 			k = 0;
 			{
 
 				if(gopt.realtime)
-					usleep(1000);
+					usleep(1000*pOverload->getStretch());
 
 				/* Do the 10 ms of coherent integration */
 				for(lcv3 = 0; lcv3 < 10; lcv3++)
@@ -402,6 +650,7 @@ Acq_Command_S Acquisition::doAcqMedium(int32 _sv, int32 _doppmin, int32 _doppmax
 					result->code_phase = index;
 					result->doppler = (lcv*1000) + (lcv2*250) + (indext/resamps_ms)*25.0;
 					result->magnitude = mag;
+					result->count = request.count;
 				}
 
 			}//end k
@@ -434,7 +683,7 @@ Acq_Command_S Acquisition::doAcqWeak(int32 _sv, int32 _doppmin, int32 _doppmax)
 {
 
 	Acq_Command_S *result;
-	int32 lcv, lcv2, lcv3, mag, magt, index, indext, k, i, j, skip, dopp;
+	int32 lcv, lcv2, lcv3, mag, magt, index, indext, k, i, j, skip, dopp, cell;
 	int32 iaccum, qaccum;
 	int32 data[32];
 	CPX *dp = (CPX *)&data[0];
@@ -448,13 +697,30 @@ Acq_Command_S Acquisition::doAcqWeak(int32 _sv, int32 _doppmin, int32 _doppmax)
 	result = &results[_sv];
 	index = indext = mag = magt = 0;
 
+	/* Resuming, seed with the best-so-far */
+	if(request.cursor > 0)
+		mag = result->magnitude;
+
 	/* Sweeps through the doppler range */
-	for(lcv = (_doppmin/1000); lcv <  (_doppmax/1000); lcv++)
+	for(lcv = (_doppmin/1000); (lcv <  (_doppmax/1000)) && !result->partial; lcv++)
 	{
 
 		/* Covers the 250 Hz spacing */
 		for(lcv2 = 0; lcv2 < 4; lcv2++)
 		{
+			/* Skip what an earlier slice already searched */
+			cell = 4*(lcv - _doppmin/1000) + lcv2;
+			if(cell < request.cursor)
+				continue;
+
+			/* Out of time or cancelled, remember where to pick up */
+			if(Preempted())
+			{
+				result->cursor = cell;
+				result->partial = 1;
+				break;
+			}
+
 			/* Do both even and odd */
 			for(k = 0; k < 2; k++)
 			{
@@ -467,7 +733,7 @@ Acq_Command_S Acquisition::doAcqWeak(int32 _sv, int32 _doppmin, int32 _doppmax)
 				{
 
 					if(gopt.realtime)
-						usleep(1000);
+						usleep(1000*pOverload->getStretch());
 
 					/* Do the 10 ms of coherent integration */
 					for(lcv3 = 0; lcv3 < 10; lcv3++)
@@ -548,6 +814,7 @@ Acq_Command_S Acquisition::doAcqWeak(int32 _sv, int32 _doppmin, int32 _doppmax)
 					result->code_phase = index;
 					result->doppler = (lcv*1000) + (lcv2*250) + (indext/resamps_ms)*25.0;
 					result->magnitude = mag;
+					result->count = request.count;
 				}
 
 			}//end k
@@ -581,11 +848,19 @@ void Acquisition::Acquire()
 
 	IncStopTic();
 
+	/* Start the clock on this request's compute budget */
+	gettimeofday(&job_start, NULL);
+	job_cells = 0;
+
 	switch(request.type)
 	{
 		case ACQ_TYPE_STRONG:
 			doPrepIF(ACQ_TYPE_STRONG, buff);
-			doAcqStrong(request.sv, request.mindopp, request.maxdopp);
+			doAcqStrong(request.sv, request.mindopp, request.maxdopp, request.cendopp);
+
+			/* Only spend ACQ_FINE_MS on a real detection, THRESH_STRONG passes everything */
+			if(strong_pnr > ACQ_FINE_PNR)
+				doAcqFine(request.sv);
 			break;
 		case ACQ_TYPE_MEDIUM:
 			doPrepIF(ACQ_TYPE_MEDIUM, buff);
@@ -596,7 +871,7 @@ void Acquisition::Acquire()
 			doAcqWeak(request.sv, request.mindopp, request.maxdopp);
 			break;
 		default:
-			doAcqStrong(request.sv, request.mindopp, request.maxdopp);
+			doAcqStrong(request.sv, request.mindopp, request.maxdopp, request.cendopp);
 	}
 
 	IncStartTic();
@@ -610,20 +885,26 @@ void Acquisition::Acquire()
  * */
 void Acquisition::Import()
 {
-	int32 last;
 	int32 bread;
-	int32 lastcount;
 	int32 ms;
 	int32 ms_per_read;
-	int32 lcv;
-	timespec ret;
-
-	ret.tv_sec = 0;
-	ret.tv_nsec = 100000;
+	Acq_Command_S prev;
 
-	/* First wait for a request */
+	/* First wait for a request, a Cancel() from here on applies to it */
+	cancel = false;
 	bread = read(SVS_2_ACQ_P[READ], &request, sizeof(Acq_Command_S));
-	memcpy(&results[request.sv],&request,sizeof(Acq_Command_S));
+	busy = true;
+
+	/* A resumed search carries its best-so-far over from the earlier slices */
+	memcpy(&prev, &results[request.sv], sizeof(Acq_Command_S));
+	memcpy(&results[request.sv], &request, sizeof(Acq_Command_S));
+	if(request.cursor > 0)
+	{
+		results[request.sv].code_phase	= prev.code_phase;
+		results[request.sv].doppler		= prev.doppler;
+		results[request.sv].magnitude	= prev.magnitude;
+		results[request.sv].count		= prev.count;
+	}
 
 	switch(request.type)
 	{
@@ -640,38 +921,18 @@ void Acquisition::Import()
 			ms_per_read = 310;
 	}
 
-	/* Flush the pipe */
-	for(lcv = 0; lcv < 10; lcv++)
-		read(COR_2_ACQ_P[READ], &packet, sizeof(ms_packet));
-
-	/* Collect necessary data */
-	lastcount = 0; ms = 0;
-	while((ms < ms_per_read) && grun)
-	{
-		/* Get the tail */
-		last = packet.count;
-
-		/* Read a packet in */
-		read(COR_2_ACQ_P[READ], &packet, sizeof(ms_packet));
-
-		memcpy(&buff[SAMPS_MS*ms], &packet.data, SAMPS_MS*sizeof(CPX));
+	/* Pin fresh IF data in the FIFO, the packets are contiguous by construction */
+	request.count = pFIFO->Snapshot(ms_per_read);
 
-		/* Detect broken packets */
-		if(ms > 0)
-		{
-			if((packet.count - lastcount) != 1)
-			{
-				fprintf(stdout,"Broken GPS stream %d,%d\n",packet.count,lastcount);
-				ms = 0; /* Recollect data */
-			}
-		}
-		else
-			request.count = packet.count;
+	if(request.cursor == 0)
+		results[request.sv].count = request.count;
 
-		ms++;
-		lastcount = packet.count;
+	/* Collect necessary data straight out of the ring */
+	for(ms = 0; ms < ms_per_read; ms++)
+		memcpy(&buff[SAMPS_MS*ms], pFIFO->getSnapshot(ms)->payload[0], SAMPS_MS*sizeof(CPX));
 
-	}
+	/* The searches work on the copy, let the producer have the ring back */
+	pFIFO->Release();
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -710,8 +971,8 @@ void Acquisition::Export(char * _fname)
 //	}
 //	fclose(fp);
 
-	/* Write result to the tracking task */
-	results[request.sv].count = request.count;
+	/* Write result to the tracking task, count is that of the data the best-so-far came from */
+	busy = false;
 	write(ACQ_2_SVS_P[WRITE], &results[request.sv], sizeof(Acq_Command_S));
 
 }
@@ -742,3 +1003,51 @@ void Acquisition::doRotate(CPX *_in, int32 _pts)
 }
 /*----------------------------------------------------------------------------------------------*/
 
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Preempted: Should the current search yield? True if the request was cancelled, the receiver is
+ * shutting down, or the request's compute budget (in ms, 0 for none) has been used up.
+ * */
+bool Acquisition::Preempted()
+{
+
+	struct timeval now;
+	int32 elapsed;
+
+	if(cancel || !grun)
+		return(true);
+
+	if(request.budget > 0)
+	{
+		/* Off the sample clock count searched cells (~1 ms each) so the yield points are reproducible */
+		if(gopt.realtime)
+		{
+			gettimeofday(&now, NULL);
+			elapsed = 1000*(now.tv_sec - job_start.tv_sec) + (now.tv_usec - job_start.tv_usec)/1000;
+		}
+		else
+			elapsed = job_cells++;
+
+		if(elapsed >= request.budget)
+			return(true);
+	}
+
+	return(false);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Cancel: Stop the current search at the next Doppler cell, it returns its best-so-far as a partial
+ * result along with a cursor to resume from.
+ * */
+void Acquisition::Cancel()
+{
+
+	cancel = true;
+
+}
+/*----------------------------------------------------------------------------------------------*/
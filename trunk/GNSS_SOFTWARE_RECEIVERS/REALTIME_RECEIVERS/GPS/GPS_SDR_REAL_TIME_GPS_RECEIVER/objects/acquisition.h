@@ -32,6 +32,7 @@
 #include "sv_select.h"
 #include "fifo.h"
 #include "fft.h"
+#include "code_cache.h"
 
 /*! @ingroup CLASSES
 	@brief /xyzzy */
@@ -42,8 +43,8 @@ class Acquisition : public Threaded_Object
 
 		pthread_t thread;
 		CPX *fft_codes[MAX_SV];				//!< Store the FFTd Codes;
+		Code_Cache *pCodes;					//!< Where the FFTd codes live
 
-		ms_packet packet;						//!< Get IF data
 		CPX *buff;								//!< Result after mixing the buffer to baseband
 		CPX *baseband;							//!< Result after mixing the buffer to baseband
 		CPX *baseband_shift;					//!< Result after mixing the buffer to baseband, used for the "circular shifts"
@@ -57,6 +58,11 @@ class Acquisition : public Threaded_Object
 		CPX *msbuff;							//!< Random buffer for 1 ms stuff
 		CPX *power;
 		MIX *dft;								//!< Used for the post correlation DFT
+		double *fine_i;							//!< Squared prompt of the fine stage
+		double *fine_q;							//!< Squared prompt of the fine stage
+		double *fine_spectrum;					//!< Power across the fine Doppler sweep
+		int32 fine_bins;						//!< Number of fine Doppler bins
+		float strong_pnr;						//!< Peak-to-noise of the last strong result
 		MIX **dft_rows;							//!< Used for the post correlation DFT
 
 		float fbase;							//!< The base sample rate (2048 samps/ms);
@@ -67,6 +73,7 @@ class Acquisition : public Threaded_Object
 
 		FFT *pFFT;								//!< The FFT used to perform correlation
 		FFT *piFFT;								//!< The FFT used to perform correlation
+		FFT *pdFFT;								//!< Half length iFFT for the coarse stage of the strong search
 		FFT *pcFFT;								//!< The FFT used to perform the coherent integration
 
 		int32 sv;								//!< Search for this SV
@@ -74,12 +81,17 @@ class Acquisition : public Threaded_Object
 		int32 corr;								//!< This correlator requested an acquisition
 		Acq_Command_S request;					//!< Acquisition transaction
 		Acq_Command_S results[MAX_SV];			//!< Where to store the results
+		volatile bool cancel;					//!< Cancel the current search
+		volatile bool busy;						//!< A search is in progress
+		struct timeval job_start;				//!< Start of the current search, for the compute budget
+		int32 job_cells;						//!< Cells searched so far, the budget when off the sample clock
 
 	public:
 
 		Acquisition(float _fsample, float _fif);											//!< Create and initialize object, need _fsample as a necessary argument
 		~Acquisition();																		//!< Shutdown gracefully
-		Acq_Command_S doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax); 				//!< Look for this sv in this doppler range using a 1 ms correlation (_buff must be 1 ms long)
+		Acq_Command_S doAcqStrong(int32 _sv, int32 _doppmin, int32 _doppmax, int32 _doppcen);	//!< Look for this sv in this doppler range using a 1 ms correlation, spiraling out from _doppcen (_buff must be 1 ms long)
+		Acq_Command_S doAcqFine(int32 _sv);													//!< Refine the Doppler of a successful acquisition using the pinned snapshot
 		Acq_Command_S doAcqMedium(int32 _sv, int32 _doppmin, int32 _doppmax); 				//!< Look for this sv in this doppler range using a 10 ms correlation (_buff must be 20 ms long)
 		Acq_Command_S doAcqWeak(int32 _sv, int32 _doppmin, int32 _doppmax); 				//!< Look for this sv in this doppler range using a 10 ms correlation and 15 incoherent integrations (_buff must be 310 ms long)
 		void doPrepIF(int32 _type, CPX *_buff);												//!< Prep the IF (done once if detecting multiple SVs in same data set)
@@ -88,6 +100,10 @@ class Acquisition : public Threaded_Object
 		void Export(char *_fname);															//!< Dump results
 		void Acquire();																		//!< Acquire with respect to current state
 		void Start();
+		void Cancel();																		//!< Cancel the current search, returns a partial result
+		bool Preempted();																	//!< Should the current search yield?
+		int32 getSV(){return(busy ? request.sv : -1);}										//!< SV being searched, -1 if idle
+		int32 getType(){return(busy ? request.type : -1);}									//!< Type of the search in progress, -1 if idle
 
 };
 
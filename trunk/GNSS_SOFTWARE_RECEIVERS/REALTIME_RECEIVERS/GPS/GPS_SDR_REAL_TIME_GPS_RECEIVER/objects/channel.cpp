@@ -26,25 +26,26 @@
 /*----------------------------------------------------------------------------------------------*/
 
 #include "channel.h"
+#include "sv_select.h"
+#include "correlator.h"
+#include "tracer.h"
 
 /*----------------------------------------------------------------------------------------------*/
 Channel::Channel(int32 _chan):Threaded_Object("CHNTASK")
 {
-	char fname[1024];
+	int32 lcv;
 
 	chan = _chan;
 
 	if(gopt.verbose)
 		fprintf(stdout,"Creating Channel %d\n",chan);
 
-	if(gopt.log_channel)
+	for(lcv = 0; lcv < FLOCK_BINS; lcv++)
 	{
-		sprintf(fname,"chan%02d.dat",chan);
-		fp = fopen(fname, "wb");
+		flock_wi[lcv] = cos(TWO_PI*(double)lcv/(double)FLOCK_BINS);
+		flock_wq[lcv] = sin(TWO_PI*(double)lcv/(double)FLOCK_BINS);
 	}
 
-	pFFT = new FFT(FREQ_LOCK_POINTS);
-
 	Clear();
 
 }
@@ -55,11 +56,6 @@ Channel::Channel(int32 _chan):Threaded_Object("CHNTASK")
 Channel::~Channel()
 {
 
-	delete pFFT;
-
-	if(gopt.log_channel)
-		fclose(fp);
-
 	if(gopt.verbose)
 		fprintf(stdout,"Destructing Channel %d\n",chan);
 
@@ -78,8 +74,8 @@ void Channel::Clear()
 	sv = 666;
 
 	/* Loop data */
-	memset(&aPLL, 0x0, sizeof(Phase_lock_loop));
-	memset(&aDLL, 0x0, sizeof(Delay_lock_loop));
+	dumped = false;
+	pLoops->Clear(chan);
 
 	/* Correlations */
 	I[0] = I[1] = I[2] = 1;
@@ -111,18 +107,18 @@ void Channel::Clear()
 	z_lock = false;
 	frame_z = 0;
 	z_count = 0;
-	memset(&word_buff, 0x0, FRAME_SIZE_PLUS_2*sizeof(uint32));
+	memset(&nav_bits, 0x0, (NAV_BITS/32)*sizeof(uint32));
+	nav_count = nav_start = nav_search = nav_frame = 0;
 
 	/* Frame synch, process data bit sheit */
 	frame_lock = false;
 	frame_lock_pend = false;
-	bit_number = 0;
+	frame_epoch = 0;
 	subframe = 0;
 
-	/* FFT and buffer for FFT estimate of frequency after initial lock */
-	freq_lock_ticks = 0;
-	freq_lock = false;
-	memset(&fft_buff[0], 0x0, FREQ_LOCK_POINTS*sizeof(CPX));
+	/* Sliding DFT estimate of frequency after initial lock */
+	pull_in = -1;
+	FrequencyReset();
 
 
 }
@@ -140,11 +136,14 @@ void Channel::Start(int32 _sv, Acq_Command_S result, int32 _corr_len)
 	code_nco	= CODE_RATE + result.doppler*CODE_RATE/L1;
 	carrier_nco	= IF_FREQUENCY + result.doppler;
 
-	aDLL.x		= 2.0*result.doppler*CODE_RATE/L1;
+	pLoops->Start(chan, result.doppler);
 
-	aPLL.w		= 0;
-	aPLL.x 		= 2.0*result.doppler;
-	aPLL.z 		= result.doppler;
+	/* Doppler has already been refined by the acquisition, skip FrequencyLock() */
+	if(result.type == ACQ_TYPE_FINE)
+	{
+		freq_lock = true;
+		pull_in = 0;
+	}
 
 	switch(_corr_len)
 	{
@@ -162,8 +161,6 @@ void Channel::Start(int32 _sv, Acq_Command_S result, int32 _corr_len)
 			break;
 	}
 
-	DLL_W(1.0);
-
 	state = CHANNEL_NORMAL;
 
 }
@@ -179,7 +176,7 @@ Channel_M Channel::getPacket()
 
 
 /*----------------------------------------------------------------------------------------------*/
-void Channel::Accum(Correlation_S *corr, NCO_Command_S *_feedback)
+void Channel::Accum(Correlation_S *corr)
 {
 
 	corr->I[0] >>= 2;
@@ -221,6 +218,25 @@ void Channel::Accum(Correlation_S *corr, NCO_Command_S *_feedback)
 		DumpAccum();
 	}
 
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Channel::Feedback(NCO_Command_S *_feedback)
+{
+
+	/* Pick up the loop outputs */
+	if(dumped)
+	{
+		carrier_nco = IF_FREQUENCY + pLoops->getCarrier(chan);
+		code_nco = CODE_RATE + pLoops->getCode(chan);
+		dumped = false;
+
+		/* Dump pertinent data */
+		Error();
+	}
+
 	/* These functions must be called every ms */
 	EstCN0();
 	BitLock();
@@ -249,6 +265,7 @@ void Channel::Accum(Correlation_S *corr, NCO_Command_S *_feedback)
 	if(frame_lock_pend)
 	{
 		_feedback->reset_20ms = true;
+		_feedback->_20ms_epoch = frame_epoch;
 		frame_lock_pend = false;
 	}
 	else
@@ -281,6 +298,8 @@ void Channel::Accum(Correlation_S *corr, NCO_Command_S *_feedback)
 /*----------------------------------------------------------------------------------------------*/
 void Channel::DumpAccum()
 {
+	bool pll, pull;
+
 	/* Compute the powers */
 	P[0] = (I[0] * I[0]) + (Q[0] * Q[0]);
 	P[1] = (I[1] * I[1]) + (Q[1] * Q[1]);
@@ -291,20 +310,17 @@ void Channel::DumpAccum()
 	Q_var += ((float)Q[1]*(float)Q[1] - Q_var) * .02;
 	P_avg += ((float)P[1]/len - P_avg) * .02;
 
-	/* First do estimate of frequency offset via FFT */
-	if(freq_lock == false)
-	{
-		FrequencyLock();
-	}
-	else
-	{
-		PLL();
-	}
+	/* Pull the code in until the correlation is up */
+	pull = (count < 1000) && (P_avg < 8e4);
 
-	DLL();
+	/* First estimate the frequency offset, after that the PLL runs. The loops of all the
+	 * channels are closed together by pLoops->Update() */
+	pll = freq_lock;
+	if((freq_lock == false) && (count > FLOCK_SETTLE_MS) && !pull)
+		FrequencyLock();
 
-	/* Dump pertinent data */
-	Error();
+	pLoops->Load(chan, I[1], Q[1], P[0], P[2], pll, pull);
+	dumped = true;
 
 	/* Save Previous Correlations for Loops */
 	I_prev = I[1];
@@ -356,143 +372,104 @@ void Channel::EstCN0()
 
 
 /*----------------------------------------------------------------------------------------------*/
+/*!
+ * FrequencyLock: The prompt is squared to strip the data bits and fed through a FLOCK_BINS point
+ * sliding DFT, so there is always a spectrum of the latest FLOCK_BINS dumps at hand for the cost of one
+ * complex multiply per bin. Every FLOCK_HOP dumps it is added into flock_power, and lock is declared as
+ * soon as the peak clears FLOCK_CONFIDENCE times the mean of the bins away from it. The peak is
+ * refined by a parabola through its neighbours.
+ * */
 void Channel::FrequencyLock()
 {
 
-	int32 it, qt;
-	int32 max, mind, lcv;
+	int32 lcv, k, mind;
+	double xi, xq, si, sq, max, noise, den, delta;
 	float df;
-	int32 *p;
-
-	it = I[1] >> 3;
-	qt = Q[1] >> 3;
 
 	/* First frequency double to remove data bits */
-	if(count > 1000)
-	{
-		fft_buff[freq_lock_ticks].i = (int16)(it*it - qt*qt);
-		fft_buff[freq_lock_ticks].q = (int16)(2*it*qt);
-		freq_lock_ticks++;
-	}
+	xi = (double)I[1]*(double)I[1] - (double)Q[1]*(double)Q[1];
+	xq = 2.0*(double)I[1]*(double)Q[1];
 
-	if(freq_lock_ticks >= FREQ_LOCK_POINTS)
+	/* Slide the DFT, drop the oldest point and add the newest */
+	k = freq_lock_ticks % FLOCK_BINS;
+	for(lcv = 0; lcv < FLOCK_BINS; lcv++)
 	{
+		si = flock_si[lcv] - flock_xi[k] + xi;
+		sq = flock_sq[lcv] - flock_xq[k] + xq;
+		flock_si[lcv] = si*flock_wi[lcv] - sq*flock_wq[lcv];
+		flock_sq[lcv] = si*flock_wq[lcv] + sq*flock_wi[lcv];
+	}
+	flock_xi[k] = xi;
+	flock_xq[k] = xq;
+	freq_lock_ticks++;
 
-		p = (int32 *)&fft_buff[0];
-
-		/* Now do the FFT */
-		pFFT->doFFT(&fft_buff[0], true);
-
-		/* Convert to power */
-		x86_cmag(&fft_buff[0], FREQ_LOCK_POINTS);
+	if((freq_lock_ticks < FLOCK_BINS) || ((freq_lock_ticks % FLOCK_HOP) != 0))
+		return;
 
-		/* Get peak */
-		max = mind = 0;
-		for(lcv = 0; lcv < FREQ_LOCK_POINTS; lcv++)
+	/* Accumulate the spectrum and get the peak */
+	max = 0; mind = 0;
+	for(lcv = 0; lcv < FLOCK_BINS; lcv++)
+	{
+		flock_power[lcv] += flock_si[lcv]*flock_si[lcv] + flock_sq[lcv]*flock_sq[lcv];
+		if(flock_power[lcv] > max)
 		{
-			if(p[lcv] > max)
-			{
-				max = p[lcv];
-				mind = lcv;
-			}
+			max = flock_power[lcv];
+			mind = lcv;
 		}
+	}
+	freq_lock_windows++;
 
-		/* Positive and negative frequency adjustment */
-		if(mind >= (FREQ_LOCK_POINTS/2))
-			mind -= FREQ_LOCK_POINTS;
-
-		/* Convert to frequency correction */
-		df = 1000.0/((float)2.0*len);	// Bandwidth of FFT
-		df /= (float)FREQ_LOCK_POINTS;	// Spacing of FFT bins
-		df *= (float)mind;				// Convert to frequency offset
-
-		/* Update the loop filters */
-		aDLL.x += 2.0*df*CODE_RATE/L1;
-		aPLL.x += 2.0*df;
+	/* Mean of the bins away from the peak */
+	noise = 0;
+	for(lcv = 0; lcv < FLOCK_BINS; lcv++)
+		noise += flock_power[lcv];
+	for(lcv = -1; lcv <= 1; lcv++)
+		noise -= flock_power[(mind + lcv + FLOCK_BINS) % FLOCK_BINS];
+	noise /= (double)(FLOCK_BINS - 3);
 
-		freq_lock = true;
-		freq_lock_ticks = 0;
-	}
-}
-/*----------------------------------------------------------------------------------------------*/
+	if(freq_lock_windows < FLOCK_MIN_WINDOWS)
+		return;
 
+	if((max <= FLOCK_CONFIDENCE*noise) && (freq_lock_windows < FLOCK_MAX_WINDOWS))
+		return;
 
-/*----------------------------------------------------------------------------------------------*/
-/*! Make this 2nd order ? */
-void Channel::DLL()
-{
+	/* Parabolic interpolation of the magnitude around the peak */
+	si = sqrt(flock_power[(mind + FLOCK_BINS - 1) % FLOCK_BINS]);
+	sq = sqrt(flock_power[(mind + 1) % FLOCK_BINS]);
+	den = si - 2.0*sqrt(max) + sq;
+	delta = (den != 0) ? 0.5*(si - sq)/den : 0;
 
-	double code_err;
-	double ep, lp, sp;
+	/* Positive and negative frequency adjustment */
+	if(mind >= (FLOCK_BINS/2))
+		mind -= FLOCK_BINS;
 
-	ep = sqrt(double(P[0]));
-	lp = sqrt(double(P[2]));
-	sp = sqrt(double(P[2] + P[0]));
+	/* Convert to frequency correction */
+	df = 1000.0/((float)2.0*len);	// Bandwidth of the DFT
+	df /= (float)FLOCK_BINS;		// Spacing of the bins
+	df *= (float)mind + delta;		// Convert to frequency offset
 
-	code_err  = (ep - lp) / sp;
+	/* Update the loop filters */
+	pLoops->AddFrequency(chan, df);
 
-	/* Not working too well right now, debug some later */
-//	aDLL.x += aDLL.t*(code_err*aDLL.w02);
-//	aDLL.z = 0.5*aDLL.x + aDLL.a*aDLL.w02*code_err;
-//	code_nco = CODE_RATE + (0.5*aPLL.x*CODE_RATE*INVERSE_L1) + aDLL.z;
+	freq_lock = true;
+	pull_in = count;
 
-	if((count < 1000) && (P_avg < 8e4))
-	{
-		code_nco = CODE_RATE + (0.5 * aPLL.x * CODE_RATE * INVERSE_L1) - 5.0;
-	}
-	else
-	{
-		code_nco = CODE_RATE + (0.5 * aPLL.x * CODE_RATE * INVERSE_L1) + code_err;
-	}
 }
 /*----------------------------------------------------------------------------------------------*/
 
 
 /*----------------------------------------------------------------------------------------------*/
-void Channel::PLL()
+void Channel::FrequencyReset()
 {
 
-	double df;
-	double dp;
-	double dot;
-	double cross;
-	int32 I1, I2, Q1, Q2, lcv;
-
-	df = dp = 0;
-
-//	if(bit_lock)
-//	{
-//		/* FLL discriminator */
-//		dot = 	  I_prev*I[1] + Q_prev*Q[1];
-//		cross =   I_prev*Q[1] - Q_prev*I[1];
-//
-//		/* No FLL for now */
-//		if((dot != 0.0) && (cross != 0.0))
-//		{
-//			df = atan2(cross, dot);
-//			df /= (TWO_PI * aPLL.t);
-//		}
-//	}
-
-//	df = 0;
-
-	/* PLL discriminator */
-	if(I[1] != 0)
-	{
-		dp = atan((double)Q[1]/(double)I[1])/TWO_PI;
-	}
-
-	/* Lock indicators */
-	aPLL.pll_lock += (dp - aPLL.pll_lock) * .1;
-	aPLL.pll_lock = dp;
-	aPLL.fll_lock += (cross/P_avg - aPLL.fll_lock) * .1;
-
-	/* 3rd order PLL wioth 2nd order FLL assist */
-	aPLL.w += aPLL.t * (aPLL.w0p3 * dp + aPLL.w0f2 * df);
-	aPLL.x += aPLL.t * (0.5*aPLL.w + aPLL.a2 * aPLL.w0f * df + aPLL.a3 * aPLL.w0p2 * dp);
-	aPLL.z  = 0.5*aPLL.x + aPLL.b3 * aPLL.w0p * dp;
-
-	carrier_nco = IF_FREQUENCY + aPLL.z;
+	freq_lock = false;
+	freq_lock_ticks = 0;
+	freq_lock_windows = 0;
+	memset(&flock_si[0], 0x0, FLOCK_BINS*sizeof(double));
+	memset(&flock_sq[0], 0x0, FLOCK_BINS*sizeof(double));
+	memset(&flock_xi[0], 0x0, FLOCK_BINS*sizeof(double));
+	memset(&flock_xq[0], 0x0, FLOCK_BINS*sizeof(double));
+	memset(&flock_power[0], 0x0, FLOCK_BINS*sizeof(double));
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -559,6 +536,10 @@ void Channel::BitLock()
 				bit_lock_ticks = 0;
 				_1ms_epoch = (38 - new_epoch) % 20;
 
+				/* Bits from before are on the wrong edges */
+				nav_start = nav_count;
+				nav_search = 0;
+
 				/* Copy over the power buffer to put the max in element 19 */
 				for(lcv = 0 ; lcv < 20; lcv++)
 					power_buff[lcv] = P_buff[lcv];
@@ -615,34 +596,21 @@ void Channel::BitLock()
 void Channel::BitStuff()
 {
 
-	uint32 lcv, temp_bit, feedbit;
+	uint32 index;
 
 	if(bit_lock && (_1ms_epoch == 19))
 	{
 
-		/* Make a bit decision */
-		if(I_sum20 > 0)
-			temp_bit = 1;
-		else
-			temp_bit = 0;
+		/* Make a bit decision and add it to the ring, MSB first */
+		index = (nav_count >> 5) & (NAV_BITS/32 - 1);
 
-		/* Now add the bit into the buffer */
-		/* Each word in wordbuff is composed of:
-		Bits 0 to 29 = the GPS data word
-		Bits 30 to 31 = 2 LSBs of the GPS word ahead. */
-		for(lcv = 0; lcv <= (FRAME_SIZE_PLUS_2-2); lcv++)
-		{
-			/* Shift the data word 1 place to the left. */
-			word_buff[lcv] <<= 1;
+		if((nav_count & 0x1F) == 0)
+			nav_bits[index] = 0;
 
-			/* Add the MSB of the following GPS word (bit 29 of a wordbuff word). */
-			feedbit = (word_buff[lcv+1] >> 29) & 0x00000001;
-			word_buff[lcv] += feedbit;
-		}
+		if(I_sum20 > 0)
+			nav_bits[index] |= 0x80000000 >> (nav_count & 0x1F);
 
-		/* The bit added for the 12th word is the new data bit. */
-		word_buff[FRAME_SIZE_PLUS_2-1] <<= 1;
-		word_buff[FRAME_SIZE_PLUS_2-1] += temp_bit;
+		nav_count++;
 
 		ProcessDataBit();
 	}
@@ -652,77 +620,180 @@ void Channel::BitStuff()
 
 
 /*----------------------------------------------------------------------------------------------*/
+/*!
+ * ProcessDataBit: Until frame lock every new bit is handed to the frame search. Once locked nothing
+ * is done until 60 bits into the next subframe, when the TLM and HOW that close the last one are in.
+ * */
 void Channel::ProcessDataBit()
 {
 
-	int32 sid, lcv;
-	uint32 word0, word1;
-
-	/* Else attempt frame sync. */
 	if(!frame_lock)
 	{
-		word0 = word_buff[FRAME_SIZE_PLUS_2-2];
-		word1 = word_buff[FRAME_SIZE_PLUS_2-1];
+		FrameSearch();
+		return;
+	}
+
+	if((nav_count - nav_frame) == 360)
+	{
+		nav_frame += 300;
+
+		NavFrame(nav_frame - 300, &ephem_packet.word_buff[0]);
 
-		if(FrameSync(word0, word1))
+		if(ValidFrameFormat(&ephem_packet.word_buff[0]))
+			SendSubframe();
+		else
 		{
-			frame_lock = true;
-			frame_lock_pend = 1;
-			bit_number = 299;
-			_20ms_epoch = 60;
+			subframe = 0;
+			valid_frame[0] = valid_frame[1] = valid_frame[2] = valid_frame[3] = valid_frame[4] = false;
+			frame_lock = false;
+
+			/* Look back over everything still in the ring */
+			nav_search = 0;
+			FrameSearch();
 		}
 	}
 
-	if(frame_lock)
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * FrameSearch: Look for a subframe, framed by good TLM and HOW words at both ends, starting anywhere
+ * in the ring that has not been looked at yet. gps_preamble() tests 32 starting points at a time,
+ * only the few that show a preamble are checked in full. After a resync this finds the frame in the
+ * bits already received instead of waiting for the next preamble.
+ * */
+bool Channel::FrameSearch()
+{
+
+	uint32 first, last, base, mask, start;
+	int32 lcv;
+
+	/* Need the 2 bits before the TLM, the subframe, and the next TLM and HOW */
+	if(nav_count < nav_start + 362)
+		return(false);
+
+	last = nav_count - 360;
+
+	first = nav_start + 2;
+	if(nav_count - first > NAV_BITS - 32)
+		first = nav_count - (NAV_BITS - 32);
+	if(first < nav_search)
+		first = nav_search;
+
+	while(first <= last)
 	{
-		bit_number = (bit_number + 1) % 300;
+		base = first & ~0x1F;
+
+		/* Starting points from first to last */
+		mask = gps_preamble(&nav_bits[0], NAV_BITS/32, base) & (0xFFFFFFFF >> (first - base));
+		if(last - base < 31)
+			mask &= ~(0xFFFFFFFF >> (last - base + 1));
 
-		if(bit_number == 0)
+		nav_search = first = ((last - base) < 31) ? (last + 1) : (base + 32);
+
+		while(mask)
 		{
-			memcpy(&ephem_packet.word_buff[0], word_buff, FRAME_SIZE_PLUS_2*sizeof(uint32));
+			lcv = __builtin_clz(mask);
+			mask &= ~(0x80000000 >> lcv);
+			start = base + lcv;
 
-			if(ValidFrameFormat(&ephem_packet.word_buff[0]))
-			{
-				sid = (int32)((ephem_packet.word_buff[1] >> 8) & 0x00000007);
-				frame_z = 4*((ephem_packet.word_buff[1] >> 13) & 0x0001FFFF);
+			NavFrame(start, &ephem_packet.word_buff[0]);
+			if(!ValidFrameFormat(&ephem_packet.word_buff[0]))
+				continue;
 
-				if((sid > 0) && (sid < 6))
-				{
-					subframe = sid;
-					valid_frame[sid-1] = true;
-					ephem_packet.subframe = subframe;
-					ephem_packet.sv = sv;
-
-					write(CHN_2_EPH_P[WRITE], &ephem_packet, sizeof(Channel_2_Ephemeris_S));
-
-					if(!z_lock)
-					{
-						z_count_pend = true;
-						z_count = 3*frame_z/2;
-						z_lock = true;
-						navigate = true;
-						converged = true;
-					}
+			/* Locked, work out how far into the current subframe we are */
+			nav_frame = start + 300;
+			while((nav_count - nav_frame) >= 300)
+				nav_frame += 300;
 
-				}
-				else
-				{
-					subframe = 0;
-					valid_frame[0] = valid_frame[1] = valid_frame[2] = valid_frame[3] = valid_frame[4] = false;
-					frame_lock = false;
-				}
-			}		//end valid subframe
-			else
-			{
-				subframe = 0;
-				valid_frame[0] = valid_frame[1] = valid_frame[2] = valid_frame[3] = valid_frame[4] = false;
-				frame_lock = false;
-			}
-		}		//end if bit_number = 300;
+			frame_lock = true;
+			frame_lock_pend = true;
+			frame_epoch = _20ms_epoch = nav_count - nav_frame;
+
+			/* Found as soon as it was complete, the subframe is news */
+			if(nav_count - start == 360)
+				SendSubframe();
+
+			return(true);
+		}
 	}
 
+	return(false);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 Channel::NavWord(uint32 _bit)
+{
+
+	uint32 index, shift;
+
+	index = (_bit >> 5) & (NAV_BITS/32 - 1);
+	shift = _bit & 0x1F;
+
+	if(shift == 0)
+		return(nav_bits[index]);
+
+	return((nav_bits[index] << shift) | (nav_bits[(index + 1) & (NAV_BITS/32 - 1)] >> (32 - shift)));
+
+}
+/*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * NavFrame: Each word is the 30 bits of the GPS word in bits 29 to 0, with the last 2 bits of the
+ * previous word (D29* and D30*) in bits 31 and 30.
+ * */
+void Channel::NavFrame(uint32 _first, uint32 *_words)
+{
+
+	int32 lcv;
+
+	for(lcv = 0; lcv < FRAME_SIZE_PLUS_2; lcv++)
+		_words[lcv] = NavWord(_first - 2 + 30*lcv);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Channel::SendSubframe()
+{
+
+	int32 sid;
+	uint32 how;
+
+	/* The HOW, with its data bits un-inverted */
+	how = ephem_packet.word_buff[1];
+	if(how & 0x40000000)
+		how ^= 0x3FFFFFC0;
+
+	sid = (int32)((how >> 8) & 0x00000007);
+	frame_z = 4*((how >> 13) & 0x0001FFFF);
+
+	subframe = sid;
+	valid_frame[sid-1] = true;
+	ephem_packet.subframe = subframe;
+	ephem_packet.sv = sv;
+
+	/* The ephemeris checks the parity of the rest of the words */
+	write(CHN_2_EPH_P[WRITE], &ephem_packet, sizeof(Channel_2_Ephemeris_S));
+	gsubframes++;
+
+	if(!z_lock)
+	{
+		z_count_pend = true;
+		z_count = 3*frame_z/2;
+		z_lock = true;
+		navigate = true;
+		converged = true;
+	}
+
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -764,15 +835,8 @@ bool Channel::FrameSync(uint32 word0, uint32 word1)
     if(zerobits!=0)
         return false;
 
-    /* Check that the 2 most recently logged words pass parity. Have to first
-       invert the data bits according to bit 30 of the previous word. */
-    if(word0 & 0x40000000)
-        word0 ^= 0x3FFFFFC0;
-
-    if(word1 & 0x40000000)
-        word1 ^= 0x3FFFFFC0;
-
-    if(!this->ParityCheck(word0) || !this->ParityCheck(word1))
+    /* Check that the 2 most recently logged words pass parity, gps_parity() does the inversion */
+    if(!gps_parity(word0) || !gps_parity(word1))
         return false;
 
     return true;
@@ -781,125 +845,32 @@ bool Channel::FrameSync(uint32 word0, uint32 word1)
 
 
 /*----------------------------------------------------------------------------------------------*/
-bool Channel::ParityCheck(uint32 gpsword)
+/*!
+ * ValidFrameFormat: The TLM and HOW at both ends of the subframe are good and the subframe IDs follow
+ * on. The words are left as received, the parity of the rest is checked by the ephemeris.
+ * */
+bool Channel::ValidFrameFormat(uint32 *subframe)
 {
+    int32 sid, next_sid;
 
-    uint32 d1,d2,d3,d4,d5,d6,d7,t,parity;
-
-    /* XOR as many bits in parallel as possible.  The magic constants pick
-       up bits which are to be XOR'ed together to implement the GPS parity
-       check algorithm described in ICD-GPS-200.  This avoids lengthy shift-
-       and-xor loops. */
-
-    d1 = gpsword & 0xFBFFBF00;
-    d2 = _lrotl(gpsword,1) & 0x07FFBF01;
-    d3 = _lrotl(gpsword,2) & 0xFC0F8100;
-    d4 = _lrotl(gpsword,3) & 0xF81FFE02;
-    d5 = _lrotl(gpsword,4) & 0xFC00000E;
-    d6 = _lrotl(gpsword,5) & 0x07F00001;
-    d7 = _lrotl(gpsword,6) & 0x00003000;
-
-    t = d1 ^ d2 ^ d3 ^ d4 ^ d5 ^ d6 ^ d7;
-
-    // Now XOR the 5 6-bit fields together to produce the 6-bit final result.
-
-    parity = t ^ _lrotl(t,6) ^ _lrotl(t,12) ^ _lrotl(t,18) ^ _lrotl(t,24);
-    parity = parity & 0x3F;
-    if (parity == (gpsword&0x3F))
-        return(true);
-    else
+    if(!FrameSync(subframe[0], subframe[1]))
         return(false);
 
-}
-/*----------------------------------------------------------------------------------------------*/
-
-
-/*----------------------------------------------------------------------------------------------*/
-bool Channel::ValidFrameFormat(uint32 *subframe)
-{
-	uint32 preamble,next_preamble;
-    uint32 zerobits,next_zerobits;
-    uint32 sid,next_sid;
-    uint32 wordcounter;
-    uint32 parity_errors;
-
-    /* Extract the preamble. */
-    preamble = (subframe[0] >> 22) & 0x000000FF;
+    if(!FrameSync(subframe[FRAME_SIZE_PLUS_2-2], subframe[FRAME_SIZE_PLUS_2-1]))
+        return(false);
 
-    /* Extract the subframe ID. */
     sid = (subframe[1] >> 8) & 0x00000007;
-
-    /* Extract the zero bits. */
-    zerobits = subframe[1] & 0x00000003;
-
-    /* Invert the extracted data according to bit 30 of the previous word. */
-    if(subframe[0] & 0x40000000)
-	{
-		preamble ^= 0x000000FF;
-		zerobits ^= 0x00000003;
-	}
-
     if(subframe[1] & 0x40000000)
         sid ^= 0x00000007;
 
-    /* Check that the preamble, subframe and zero bits are ok. */
-    if(preamble != PREAMBLE)
-        return(false);
-
-    if(sid < 1 || sid > 5)
-        return(false);
-
-    if(zerobits != 0)
-        return(false);
-
-    /* Extract the next preamble (10001011). */
-    next_preamble = (subframe[FRAME_SIZE_PLUS_2-2] >> 22) & 0x000000FF;
-
-    /* Extract the next subframe ID. */
     next_sid = (subframe[FRAME_SIZE_PLUS_2-1] >> 8) & 0x00000007;
-
-    /* Extract the next zero bits. */
-    next_zerobits = (subframe[FRAME_SIZE_PLUS_2-1] & 0x00000003);
-
-    /* Invert the extracted data according to bit 30 of the previous word. */
-    if(subframe[FRAME_SIZE_PLUS_2-2] & 0x40000000)
-	{
-		next_preamble ^= 0x000000FF;
-		next_zerobits ^= 0x00000003;
-	}
-
     if(subframe[FRAME_SIZE_PLUS_2-1] & 0x40000000)
         next_sid ^= 0x00000007;
 
-    /* Check that the preamble, subframe and zero bits are ok. */
-    if(next_preamble != PREAMBLE)
-        return(false);
-
-    if(next_sid < 1 || next_sid > 5)
-        return(false);
-
-    if(next_zerobits != 0)
-        return(false);
-
     /* Check that the subframe IDs are consistent. */
     if((next_sid-sid) != 1 && (next_sid-sid) != -4)
         return(false);
 
-    /* Check that all 12 words have correct parity. Have to first
-       invert the data bits according to bit 30 of the previous word. */
-    parity_errors = 0;
-
-	for(wordcounter = 0; wordcounter < FRAME_SIZE_PLUS_2; wordcounter++)
-		if (subframe[wordcounter] & 0x40000000)
-			subframe[wordcounter] ^= 0x3FFFFFC0;
-
-    for(wordcounter = 0; wordcounter < FRAME_SIZE_PLUS_2; wordcounter++)
-		if (!this->ParityCheck(subframe[wordcounter]))
-			parity_errors++;
-
-    if(parity_errors != 0)
-        return(false);
-
     return(true);
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -909,33 +880,7 @@ bool Channel::ValidFrameFormat(uint32 *subframe)
 void Channel::PLL_W(float _bwpll)
 {
 
-	aPLL.PLLBW = _bwpll;
-	aPLL.FLLBW = 4.0;
-
-	aPLL.b3 = 2.40;
-	aPLL.a3 = 1.10;
-	aPLL.a2 = 1.414;
-	aPLL.w0p = aPLL.PLLBW/0.7845;
-	aPLL.w0p2 = aPLL.w0p*aPLL.w0p;
-	aPLL.w0p3 = aPLL.w0p2*aPLL.w0p;
-	aPLL.w0f = aPLL.FLLBW/0.53;
-	aPLL.w0f2 = aPLL.w0f*aPLL.w0f;
-	aPLL.gain = 1.0;
-	aPLL.t = .001*(float)len;
-
-}
-/*----------------------------------------------------------------------------------------------*/
-
-
-/*----------------------------------------------------------------------------------------------*/
-void Channel::DLL_W(float _bwdll)
-{
-
-	aDLL.DLLBW = _bwdll;
-	aDLL.a = 1.414;
-	aDLL.w0 = aDLL.DLLBW/0.7845;
-	aDLL.w02 = aDLL.w0*aDLL.w0;
-	aDLL.t = .001*(float)len;
+	pLoops->Bandwidth(chan, _bwpll, len);
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -952,8 +897,8 @@ void Channel::Error()
 	/* Monitor cn0 for false PLL lock */
 	if((count == 15000) && (bit_lock == false) && (freq_lock == true))
 	{
-		freq_lock_ticks = 0;
-		freq_lock = false;
+		FrequencyReset();
+		pull_in = -1;
 	}
 
 	/* If 30 seconds have passed and channel has not converged dump it */
@@ -997,20 +942,21 @@ void Channel::Kill()
 void Channel::Export()
 {
 
-	int32 bwrote;
+	Trace_Record_S record;
 
 	packet.chan 		= chan;
 	packet.state		= state;
 	packet.sv 			= sv;
 	packet.antenna		= antenna;
 	packet.len 			= len;
-	packet.w			= aPLL.w;
-	packet.x 			= aPLL.x;
-	packet.z 			= aPLL.z;
+	packet.w			= pLoops->getW(chan);
+	packet.x 			= pLoops->getX(chan);
+	packet.z 			= pLoops->getZ(chan);
 	packet.cn0 			= cn0;
 	packet.p_avg 		= P_avg;
 	packet.bit_lock 	= bit_lock;
 	packet.frame_lock 	= frame_lock;
+	packet.pull_in		= pull_in;
 	packet.navigate		= navigate;
 	packet.count		= count;
 	packet.subframe 	= subframe;
@@ -1018,14 +964,38 @@ void Channel::Export()
 	packet.code_nco 	= code_nco;
 	packet.carrier_nco 	= carrier_nco;
 
-	/* Dump the extra info */
-	if(gopt.log_channel && (fp != NULL))
+	/* Trace the dump, this only copies it into the channel's ring */
+	if(pTracer != NULL)
 	{
-		fwrite(&packet, sizeof(Channel_M), 1,  fp);
-		fwrite(&I[0], sizeof(int32), 3,  fp);
-		fwrite(&Q[0], sizeof(int32), 3,  fp);
-		fwrite(&P_buff[0], sizeof(int32), 20,  fp);
+		record.tic			= pCorrelator->getTic();
+		record.count		= count;
+		record.chan			= chan;
+		record.sv			= sv;
+		record.state		= state;
+		record.len			= len;
+		record.flags		= (bit_lock ? TRACE_BIT_LOCK : 0) | (frame_lock ? TRACE_FRAME_LOCK : 0) |
+							  (freq_lock ? TRACE_FREQ_LOCK : 0) | (navigate ? TRACE_NAVIGATE : 0);
+		record.antenna		= antenna;
+		record.subframe		= subframe;
+		record.best_epoch	= best_epoch;
+		record.I[0]			= I[0];
+		record.I[1]			= I[1];
+		record.I[2]			= I[2];
+		record.Q[0]			= Q[0];
+		record.Q[1]			= Q[1];
+		record.Q[2]			= Q[2];
+		record.carrier_nco	= carrier_nco;
+		record.code_nco		= code_nco;
+		record.cn0			= cn0;
+		record.p_avg		= P_avg;
+		record.w			= pLoops->getW(chan);
+		record.x			= pLoops->getX(chan);
+		record.z			= pLoops->getZ(chan);
+		record.pull_in		= pull_in;
+
+		pTracer->Push(chan, &record);
 	}
+
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -30,6 +30,7 @@
 
 #include "includes.h"
 #include "fft.h"
+#include "loop_bank.h"
 
 enum Channel_State
 {
@@ -39,8 +40,6 @@ enum Channel_State
 	CHANNEL_NORMAL			//!< Channel is tracking normally (post bit lock)
 };
 
-#define FREQ_LOCK_POINTS (512)
-
 /*! \ingroup CLASSES
  *
  */
@@ -54,7 +53,6 @@ class Channel : public Threaded_Object
 
 		/* Status info */
 		/*----------------------------------------------------------------------------------------------*/
-		FILE *fp;
 		int32 len;				//!< accumulation length
 		int32 count;			//!< number of accumulations processed
 		int32 active;			//!< is this channel active
@@ -66,10 +64,9 @@ class Channel : public Threaded_Object
 		Channel_2_Ephemeris_S ephem_packet; //!< dump to ephemeris
 		/*----------------------------------------------------------------------------------------------*/
 
-		/* Loop data */
+		/* Loop data, the loop filters themselves live in pLoops */
 		/*----------------------------------------------------------------------------------------------*/
-		Phase_lock_loop aPLL;
-		Delay_lock_loop	aDLL;
+		bool dumped;			//!< Loaded a dump into pLoops this ms
 		double carrier_nco;		//!< Local carrier_nco
 		double code_nco;		//!< Local code_nco
 		bool frequency_lock;
@@ -113,23 +110,34 @@ class Channel : public Threaded_Object
 		int32 frame_z;			//!< Current z count
 		int32 z_count;			//!< Zc incremented by _20ms counter
 		int32 z_count_pend;		//!< Has the z count been fed to the correlator yet
-		uint32 word_buff[FRAME_SIZE_PLUS_2]; //!< Buffer for 12 GPS words.
+		uint32 nav_bits[NAV_BITS/32];	//!< Ring of the data bits, MSB first
+		uint32 nav_count;		//!< Data bits received
+		uint32 nav_start;		//!< First bit since bit lock
+		uint32 nav_search;		//!< First bit the frame search has not looked at yet
+		uint32 nav_frame;		//!< First bit of the current subframe
 		/*----------------------------------------------------------------------------------------------*/
 
 		/* Frame synch, process data bit sheit */
 		/*----------------------------------------------------------------------------------------------*/
 		bool frame_lock;		//!< Frame_lock
 		bool frame_lock_pend;	//!< Pending to send _20ms_epoch reset command to correlator
-		int32 bit_number;		//!< Ummm, the bit number in the subframe
+		int32 frame_epoch;		//!< _20ms_epoch to reset the correlator to
 		int32 subframe;			//!< The current subframe
 		/*----------------------------------------------------------------------------------------------*/
 
-		/* FFT and buffer for FFT estimate of frequency after initial lock
+		/* Sliding DFT estimate of frequency after initial lock */
 		/*----------------------------------------------------------------------------------------------*/
-		bool freq_lock;				//!< Has the FFT estimate of frequency been completed?
-		int32 freq_lock_ticks;
-		CPX fft_buff[FREQ_LOCK_POINTS];	//!< Buffer for the 4 ms accumulations
-		FFT *pFFT;					//!< This is where the actual FFT lives
+		bool freq_lock;				//!< Has the frequency estimate been completed?
+		int32 freq_lock_ticks;		//!< Squared prompts fed to the sliding DFT
+		int32 freq_lock_windows;	//!< Spectra added into flock_power
+		int32 pull_in;				//!< ms from Start() to frequency lock, -1 until locked
+		double flock_wi[FLOCK_BINS];	//!< Twiddles of the sliding DFT
+		double flock_wq[FLOCK_BINS];
+		double flock_si[FLOCK_BINS];	//!< DFT of the last FLOCK_BINS squared prompts
+		double flock_sq[FLOCK_BINS];
+		double flock_xi[FLOCK_BINS];	//!< The squared prompts themselves
+		double flock_xq[FLOCK_BINS];
+		double flock_power[FLOCK_BINS];	//!< Sum of the spectra
 		/*----------------------------------------------------------------------------------------------*/
 
 	public:
@@ -140,23 +148,25 @@ class Channel : public Threaded_Object
 		void Clear();
 		void Kill();									//!< Shutdown the channel
 		void DumpAccum();								//!< Dump the accumulation and do rest of processing
-		void FrequencyLock();							//!< Use FFT to pull in the PLL
+		void FrequencyLock();							//!< Use a sliding DFT to pull in the PLL
+		void FrequencyReset();							//!< Start the frequency estimate over
 		void PLL_W(float _bw);							//!< Change the PLL bandwidth
-		void DLL_W(float _bw);							//!< Change the DLL bandwidth
-		void PLL();										//!< Perform the phase lock loop
-		void DLL();										//!< Do the DLL
 		void EstCN0();									//!< Estimate the cn0
 		void Epoch();									//!< Increase _1ms_epoch, _20ms_epoch
 		void BitLock();									//!< Declare the bit lock?
 		void BitStuff();								//!< Get data bits from I_Sum20 and stuff them into data_buff
-		void ProcessDataBit();							//!< Process the data bits, how fun!, calls the following 3 functions
+		void ProcessDataBit();							//!< Process the data bits, how fun!, calls the following functions
+			bool FrameSearch();							//!< Look for the frame in the bits received so far
+			uint32 NavWord(uint32 _bit);				//!< The 32 bits starting at _bit
+			void NavFrame(uint32 _first, uint32 *_words);	//!< Pull out the subframe starting at _first, plus the next TLM and HOW
 			bool FrameSync(uint32 word0, uint32 word1); //!< frame synch?
-			bool ParityCheck(uint32 gpsword);			//!< parity check
 			bool ValidFrameFormat(uint32 *subframe);	//!< valid frame
+			void SendSubframe();						//!< Send ephem_packet to the ephemeris
 		void Error();									//!< look for errors in tracking, killing channel if necessary
 		void Export();									//!< Return NCO command to correlator
 		Channel_M getPacket();
-		void Accum(Correlation_S *corr, NCO_Command_S *_feedback);	//!< Process an accumulation
+		void Accum(Correlation_S *corr);				//!< Process an accumulation, loading pLoops if it is time to dump
+		void Feedback(NCO_Command_S *_feedback);		//!< Finish the ms once pLoops has been updated, return NCO command to correlator
 		float getCN0(){return(cn0);};
 		float getNCO(){return(carrier_nco);};
 		int32 getState(){return(state);};
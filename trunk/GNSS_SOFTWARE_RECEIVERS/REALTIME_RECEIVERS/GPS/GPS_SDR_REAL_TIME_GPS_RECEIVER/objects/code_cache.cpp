@@ -0,0 +1,309 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file code_cache.cpp
+//
+// FILENAME: code_cache.cpp
+//
+// DESCRIPTION: Implements member functions of the Code_Cache class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "code_cache.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Code_Cache::Code_Cache(int32 _fsample, int32 _samps)
+{
+
+	CPX *heap;
+
+	fsample = _fsample;
+	samps = _samps;
+	map = NULL;
+	map_size = sizeof(Code_Cache_Header_S) + MAX_SV*samps*sizeof(CPX);
+
+	snprintf(fname, 1024, "%s/gps-sdr-codes-%d-%d-%d.bin", CODE_CACHE_DIR, (int32)geteuid(), fsample, samps);
+
+	/* Warm cache, nothing to do */
+	if(Load())
+	{
+		if(gopt.verbose)
+			fprintf(stdout,"Mapped code spectra from %s\n",fname);
+		return;
+	}
+
+	/* Cold cache, generate then try to share it */
+	heap = new CPX[MAX_SV*samps];
+	Generate(heap);
+
+	if(Store(heap) && Load())
+	{
+		delete [] heap;
+
+		if(gopt.verbose)
+			fprintf(stdout,"Generated code spectra cache %s\n",fname);
+	}
+	else
+	{
+		/* Could not cache, just run out of the heap */
+		codes = heap;
+
+		if(gopt.verbose)
+			fprintf(stdout,"Generated code spectra (not cached)\n");
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Code_Cache::~Code_Cache()
+{
+
+	if(map != NULL)
+		munmap(map, map_size);
+	else
+		delete [] codes;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+CPX *Code_Cache::getCode(int32 _sv)
+{
+
+	return(&codes[_sv*samps]);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Code_Cache::Load()
+{
+
+	int32 fd;
+	struct stat st;
+	void *p;
+	Code_Cache_Header_S *header;
+
+	fd = open(fname, O_RDONLY | O_NOFOLLOW);
+	if(fd == -1)
+		return(false);
+
+	/* The directory is shared, only trust a file this user made that nobody else can modify */
+	if((fstat(fd, &st) == -1) || !S_ISREG(st.st_mode) || (st.st_uid != geteuid()) ||
+	   (st.st_mode & (S_IWGRP | S_IWOTH)) || (st.st_size != map_size))
+	{
+		close(fd);
+		return(false);
+	}
+
+	p = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if(p == MAP_FAILED)
+		return(false);
+
+	/* Make sure it was built for this configuration */
+	header = (Code_Cache_Header_S *)p;
+	if((header->magic != CODE_CACHE_MAGIC) || (header->version != CODE_CACHE_VERSION) ||
+	   (header->fsample != fsample) || (header->samps != samps) ||
+	   (header->nsv != MAX_SV) || (header->bits != CODE_CACHE_BITS))
+	{
+		munmap(p, map_size);
+		return(false);
+	}
+
+	map = p;
+	codes = (CPX *)((uint8 *)p + sizeof(Code_Cache_Header_S));
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Code_Cache::Store(CPX *_codes)
+{
+
+	FILE *fp;
+	char tname[1100];
+	Code_Cache_Header_S header;
+	int32 fd;
+	bool ok;
+
+	memset(&header, 0x0, sizeof(Code_Cache_Header_S));
+	header.magic	= CODE_CACHE_MAGIC;
+	header.version	= CODE_CACHE_VERSION;
+	header.fsample	= fsample;
+	header.samps	= samps;
+	header.nsv		= MAX_SV;
+	header.bits		= CODE_CACHE_BITS;
+
+	/* Write to a freshly created private file then rename, so concurrent receivers never see a partial
+	 * cache and a planted file or symlink is never written through */
+	snprintf(tname, 1100, "%s.XXXXXX", fname);
+
+	fd = mkstemp(tname);
+	if(fd == -1)
+		return(false);
+
+	fp = NULL;
+	if(fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0)
+		fp = fdopen(fd, "wb");
+
+	if(fp == NULL)
+	{
+		close(fd);
+		remove(tname);
+		return(false);
+	}
+
+	ok = (fwrite(&header, sizeof(Code_Cache_Header_S), 1, fp) == 1);
+	ok = ok && (fwrite(_codes, sizeof(CPX), MAX_SV*samps, fp) == (size_t)(MAX_SV*samps));
+	ok = (fclose(fp) == 0) && ok;
+
+	if(ok)
+		ok = (rename(tname, fname) == 0);
+
+	if(!ok)
+		remove(tname);
+
+	return(ok);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Generate: Same recipe as accessories/gen_fft_codes.m, resample the code with
+ * round(linspace(0,1022,samps)), FFT in double precision, conjugate, then scale to CODE_CACHE_BITS
+ * signed bits using the peak over all CODE_CACHE_PRNS codes and round away from zero.
+ * */
+void Code_Cache::Generate(CPX *_dest)
+{
+
+	int32 lcv, sv, index;
+	double mag, max, scale, x;
+	double *re, *im;
+	CPX chips[CODE_CHIPS];
+
+	re = new double[CODE_CACHE_PRNS*samps];
+	im = new double[CODE_CACHE_PRNS*samps];
+
+	max = 0;
+	for(sv = 0; sv < CODE_CACHE_PRNS; sv++)
+	{
+		code_gen(&chips[0], sv);
+
+		for(lcv = 0; lcv < samps; lcv++)
+		{
+			index = (int32)floor((double)lcv*(CODE_CHIPS-1)/(double)(samps-1) + 0.5);
+			re[sv*samps + lcv] = chips[index].i ? 1.0 : -1.0;
+			im[sv*samps + lcv] = 0;
+		}
+
+		Transform(&re[sv*samps], &im[sv*samps]);
+
+		for(lcv = 0; lcv < samps; lcv++)
+		{
+			mag = sqrt(re[sv*samps + lcv]*re[sv*samps + lcv] + im[sv*samps + lcv]*im[sv*samps + lcv]);
+			if(mag > max)
+				max = mag;
+		}
+	}
+
+	scale = (max > 0) ? (double)(1 << CODE_CACHE_BITS)/max : 0;
+
+	/* Conjugate and scale, rounding away from zero like MATLAB */
+	for(lcv = 0; lcv < MAX_SV*samps; lcv++)
+	{
+		x = scale*re[lcv];
+		_dest[lcv].i = (int16)((x > 0) ? floor(x + 0.5) : ceil(x - 0.5));
+		x = -scale*im[lcv];
+		_dest[lcv].q = (int16)((x > 0) ? floor(x + 0.5) : ceil(x - 0.5));
+	}
+
+	delete [] re;
+	delete [] im;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Transform: Radix-2 decimation in time FFT, samps must be a power of 2 (it always is, the
+ * acquisition's FFT class has the same requirement).
+ * */
+void Code_Cache::Transform(double *_re, double *_im)
+{
+
+	int32 lcv, lcv2, k, len;
+	double tr, ti, wr, wi, ur, ui, ang;
+
+	/* Bit reverse */
+	for(lcv = 1, lcv2 = 0; lcv < samps; lcv++)
+	{
+		k = samps >> 1;
+		while(lcv2 & k)
+		{
+			lcv2 ^= k;
+			k >>= 1;
+		}
+		lcv2 |= k;
+
+		if(lcv < lcv2)
+		{
+			tr = _re[lcv]; _re[lcv] = _re[lcv2]; _re[lcv2] = tr;
+			ti = _im[lcv]; _im[lcv] = _im[lcv2]; _im[lcv2] = ti;
+		}
+	}
+
+	/* Butterflies, twiddles computed directly to keep the rounding error at the double floor */
+	for(len = 2; len <= samps; len <<= 1)
+	{
+		for(k = 0; k < len/2; k++)
+		{
+			ang = -TWO_PI*(double)k/(double)len;
+			wr = cos(ang);
+			wi = sin(ang);
+
+			for(lcv = k; lcv < samps; lcv += len)
+			{
+				lcv2 = lcv + len/2;
+				ur = _re[lcv2]*wr - _im[lcv2]*wi;
+				ui = _re[lcv2]*wi + _im[lcv2]*wr;
+				_re[lcv2] = _re[lcv] - ur;
+				_im[lcv2] = _im[lcv] - ui;
+				_re[lcv] += ur;
+				_im[lcv] += ui;
+			}
+		}
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,83 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file code_cache.h
+//
+// FILENAME: code_cache.h
+//
+// DESCRIPTION: Defines the Code_Cache class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef CODE_CACHE_H_
+#define CODE_CACHE_H_
+
+#include "includes.h"
+
+#define CODE_CACHE_MAGIC	(0x43414353)	//!< "SCAC"
+#define CODE_CACHE_VERSION	(2)				//!< Bump if the generation changes
+#define CODE_CACHE_BITS		(9)				//!< Scale codes to this many signed bits
+#define CODE_CACHE_PRNS		(51)			//!< gen_fft_codes.m scaled by the peak over this many codes
+
+/*! \ingroup STRUCTS
+ *  @brief Header of the code spectra cache file, padded to keep the payload aligned */
+typedef struct Code_Cache_Header_S
+{
+
+	uint32	magic;				//!< CODE_CACHE_MAGIC
+	uint32	version;			//!< CODE_CACHE_VERSION
+	int32	fsample;			//!< Sample rate the codes were generated for
+	int32	samps;				//!< FFT size (samples per ms)
+	int32	nsv;				//!< Number of codes
+	int32	bits;				//!< Scaling of the codes
+	int32	pad[10];
+
+} Code_Cache_Header_S;
+
+/*! \ingroup CLASSES
+ *  @brief Conjugated FFTs of the C/A codes used by the acquisition. Generated at startup with
+ *  code_gen(), then cached to a file keyed by the user, sample rate and FFT size. The file is
+ *  memory mapped so later starts (and other receiver processes) share the pages. Only a cache
+ *  owned by this user and not writable by anyone else is trusted.
+ */
+class Code_Cache
+{
+
+	private:
+
+		CPX *codes;					//!< Start of the code spectra
+		void *map;					//!< The mapping, NULL if the cache could not be used
+		int32 map_size;				//!< Size of the mapping
+		int32 fsample;				//!< Sample rate
+		int32 samps;				//!< FFT size
+		char fname[1024];			//!< Cache file
+
+		bool Load();				//!< Map an existing cache file, true if it is valid
+		void Generate(CPX *_dest);	//!< Generate the code spectra
+		void Transform(double *_re, double *_im);	//!< In place double precision FFT of samps points
+		bool Store(CPX *_codes);	//!< Write a cache file
+
+	public:
+
+		Code_Cache(int32 _fsample, int32 _samps);	//!< Map or generate the codes
+		~Code_Cache();
+		CPX *getCode(int32 _sv);					//!< Get the spectrum of the given SV (0 based)
+};
+
+#endif /* CODE_CACHE_H_ */
@@ -26,6 +26,8 @@
 /*----------------------------------------------------------------------------------------------*/
 
 #include "correlator.h"
+#include "ephemeris.h"
+#include "acquisition.h"
 
 /*----------------------------------------------------------------------------------------------*/
 void *Correlator_Thread(void *_arg)
@@ -37,6 +39,7 @@ void *Correlator_Thread(void *_arg)
 	{
 		aCorrelator->Import();
 		aCorrelator->Correlate();
+		aCorrelator->Export();
 		aCorrelator->IncExecTic();
 	}
 
@@ -69,6 +72,12 @@ Correlator::Correlator():Threaded_Object("CORTASK")
 	size = sizeof(Correlator);
 
 	packet_count = 0;
+	packet_tic = 0;
+	measurements_sent = 0;
+	packet = NULL;
+
+	/* The correlator must see every packet */
+	reader = pFIFO->Register(pFIFO->getDepth(), true);
 
 	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
 		states[lcv].active = 0;
@@ -104,6 +113,8 @@ Correlator::Correlator():Threaded_Object("CORTASK")
 Correlator::~Correlator()
 {
 
+	pFIFO->Unregister(reader);
+
 	delete [] main_sine_table;
 	delete [] main_sine_rows;
 	delete [] main_code_table;
@@ -134,6 +145,7 @@ void Correlator::Import()
 		switch(result.type)
 		{
 			case ACQ_TYPE_STRONG:
+			case ACQ_TYPE_FINE:
 				pChannels[chan]->Start(result.sv, result, 1);
 				break;
 			case ACQ_TYPE_MEDIUM:
@@ -144,10 +156,17 @@ void Correlator::Import()
 				break;
 		}
 		pChannels[chan]->Unlock();
+
+		/* No point searching for an SV that is now being tracked */
+		if(pAcquisition->getSV() == result.sv)
+			pAcquisition->Cancel();
 	}
 
-	/* This call should block until new data is available */
-	pFIFO->Dequeue(&packet);
+	/* This call should block until new data is available, the packet is read in place. NULL
+	 * means the receiver stopped first, Correlate() and Export() then have nothing to do */
+	packet = pFIFO->Dequeue(reader);
+	if(packet == NULL)
+		return;
 
 	/* We have a new packet! */
 	packet_count++;
@@ -160,32 +179,36 @@ void Correlator::Import()
 void Correlator::Correlate()
 {
 	int32 lcv, leftover;
+	int32 done[MAX_CHANNELS];
 	CPX *if_data;
-	CPX *if_data2;
 	NCO_Command_S *f;
 	Correlation_S *c;
 	Correlator_State_S *s;
+	struct timeval t0, t1;
+
+	if(packet == NULL)
+		return;
 
 	IncStartTic();
 
+	if(gopt.realtime)
+		gettimeofday(&t0, NULL);
+
 	if((packet_count % MEASUREMENT_INT) == 0)
 	{
 		TakeMeasurements();
 	}
 
+	/* First pass, accumulate every channel up to its rollover and hand over the dump */
 	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
 	{
+		done[lcv] = -1;
+
 		if(states[lcv].active)
 		{
 			s = &states[lcv];
 			c = &correlations[lcv];
-			f = &feedback[lcv];
-			if_data = &packet.data[0][0];
-			if(gopt.mode)
-			{
-			//if_data2 = &packet.data[SAMPS_MS];
-			}			
-			leftover = SAMPS_MS;
+			if_data = packet->payload[0];
 
 			/* If the rollover occurs in this packet */
 			if(s->rollover <= SAMPS_MS)
@@ -193,68 +216,108 @@ void Correlator::Correlate()
 				/* Do the actual accumulation */
 				Accum(s, c, if_data, s->rollover);
 
-				/* Remaining number of samples to be processed in this ms packet of data */
-				leftover = SAMPS_MS - s->rollover;
-				if_data += s->rollover;
-
 				/* Update the code/carrier phase etc */
+				done[lcv] = s->rollover;
 				UpdateState(s, s->rollover);
 
 				/* Dump the accumulation */
-				DumpAccum(s, c, f, lcv);
+				DumpAccum(s, c, lcv);
+			}
+			else /* Just accumulate, no dumping */
+			{
+				/* Do the actual accumulation */
+				Accum(s, c, if_data, SAMPS_MS);
 
-				if(s->active == 0)
-					continue;
+				/* Update the code/carrier phase */
+				UpdateState(s, SAMPS_MS);
+			}
+		}
+	}
 
-				/* Now process remaining segment of IF data  */
-				if(s->rollover <= leftover) /* Rollover occurs in THIS packet of data */
-				{
-					/* Do the actual accumulation */
-					Accum(s, c, if_data, s->rollover);
+	/* Close the loops of every channel that dumped in one go */
+	pLoops->Update();
 
-					/* Remaining number of samples to be processed in this ms packet of data */
-					leftover -= s->rollover;
-					if_data += s->rollover;
+	/* Second pass, apply the feedback and process the rest of the packet with the new NCOs */
+	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
+	{
+		if(done[lcv] == -1)
+			continue;
 
-					/* Update the code/carrier phase etc */
-					UpdateState(s, s->rollover);
+		s = &states[lcv];
+		c = &correlations[lcv];
+		f = &feedback[lcv];
 
-					/* Dump the accumulation */
-					DumpAccum(s, c, f, lcv);
+		FinishDump(s, c, f, lcv);
 
-					if(s->active == 0)
-						continue;
+		if(s->active == 0)
+			continue;
 
-					/* Do the actual accumulation */
-					Accum(s, c, if_data, leftover);
+		/* Remaining number of samples to be processed in this ms packet of data */
+		if_data = packet->payload[0] + done[lcv];
+		leftover = SAMPS_MS - done[lcv];
 
-					/* Update the code/carrier phase etc */
-					UpdateState(s, leftover);
+		/* Now process remaining segment of IF data  */
+		if(s->rollover <= leftover) /* Rollover occurs in THIS packet of data */
+		{
+			/* Do the actual accumulation */
+			Accum(s, c, if_data, s->rollover);
 
-				}
-				else /* Rollover occurs in NEXT packet of data */
-				{
-					/* Do the actual accumulation */
-					Accum(s, c, if_data, leftover);
+			/* Remaining number of samples to be processed in this ms packet of data */
+			leftover -= s->rollover;
+			if_data += s->rollover;
 
-					/* Update the code/carrier phase */
-					UpdateState(s, leftover);
-				}
+			/* Update the code/carrier phase etc */
+			UpdateState(s, s->rollover);
 
-			}
-			else /* Just accumulate, no dumping */
-			{
-				/* Do the actual accumulation */
-				Accum(s, c, if_data, SAMPS_MS);
+			/* Dump the accumulation, this one is rare enough to close the loop on its own */
+			DumpAccum(s, c, lcv);
+			pLoops->Update();
+			FinishDump(s, c, f, lcv);
 
-				/* Update the code/carrier phase */
-				UpdateState(s, SAMPS_MS);
-			}
-		} //!< end if active
-	} //!< end for
+			if(s->active == 0)
+				continue;
+
+			/* Do the actual accumulation */
+			Accum(s, c, if_data, leftover);
+
+			/* Update the code/carrier phase etc */
+			UpdateState(s, leftover);
+
+		}
+		else /* Rollover occurs in NEXT packet of data */
+		{
+			/* Do the actual accumulation */
+			Accum(s, c, if_data, leftover);
+
+			/* Update the code/carrier phase */
+			UpdateState(s, leftover);
+		}
+	}
 
 	IncStopTic();
 
+	/* Tell the overload controller how long this ms took and how far behind we are */
+	if(gopt.realtime)
+	{
+		gettimeofday(&t1, NULL);
+		pOverload->Update(1000000*(t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec), pFIFO->getLag(reader));
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Correlator::Export()
+{
+
+	if(packet == NULL)
+		return;
+
+	/* Done with the packet, give the slot back to the FIFO */
+	packet_tic = packet->count;
+	pFIFO->Retire(reader);
+
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -345,9 +408,19 @@ void Correlator::TakeMeasurements()
 	/* Write the preamble, then the measurements */
 	if((measurement_tic % MEASUREMENT_MOD) == 0)
 	{
+		/* Off the sample clock, let the ephemeris catch up so the PVT sees the same subframes every run */
+		while(!gopt.realtime && (pEphemeris->getExecTic() < (uint32)gsubframes) && grun)
+			usleep(100);
+
 		write(ISRM_2_PVT_P[WRITE], &measurements, MAX_CHANNELS*sizeof(Measurement_M));
 		preamble.tic_measurement = measurement_tic;
 		write(ISRP_2_PVT_P[WRITE], &preamble, sizeof(Preamble_2_PVT_S));
+		measurements_sent++;
+
+		/* Then hold the samples until SV Select has acted on this epoch, any channel it starts is
+		 * picked up on the next packet */
+		while(!gopt.realtime && (pSV_Select->getExecTic() < measurements_sent) && grun)
+			usleep(100);
 	}
 
 }
@@ -450,12 +523,10 @@ void Correlator::Accum(Correlator_State_S *s, Correlation_S *c, CPX *data, int32
 
 
 /*----------------------------------------------------------------------------------------------*/
-void Correlator::DumpAccum(Correlator_State_S *s, Correlation_S *c,  NCO_Command_S *f, int32 _chan)
+void Correlator::DumpAccum(Correlator_State_S *s, Correlation_S *c, int32 _chan)
 {
 	double f1, f2, fix, ang;
 	double sang, cang, tI, tQ;
-	double code_phase;
-	int32 bin, offset, lcv, bread;
 
 	/* First rotate correlation based on nco frequency and actually frequency used for correlation */
 	f1 = ((s->sbin - CARRIER_BINS) * CARRIER_SPACING) + IF_FREQUENCY;
@@ -479,9 +550,23 @@ void Correlator::DumpAccum(Correlator_State_S *s, Correlation_S *c,  NCO_Command
 	c->I[2] = (int32)floor(cang*tI - sang*tQ);
 	c->Q[2] = (int32)floor(sang*tI + cang*tQ);
 
+	/* Hand it over, the channel loads its loops */
+	pChannels[_chan]->Lock();
+	pChannels[_chan]->Accum(c);
+	pChannels[_chan]->Unlock();
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Correlator::FinishDump(Correlator_State_S *s, Correlation_S *c, NCO_Command_S *f, int32 _chan)
+{
+	int32 bin;
+
 	/* Get the f */
 	pChannels[_chan]->Lock();
-	pChannels[_chan]->Accum(c, f);
+	pChannels[_chan]->Feedback(f);
 	pChannels[_chan]->Unlock();
 
 	 /* Apply f */
@@ -541,7 +626,7 @@ void Correlator::ProcessFeedback(Correlator_State_S *s, NCO_Command_S *f)
 		s->_1ms_epoch = 0;
 
 	if(f->reset_20ms)
-		s->_20ms_epoch = 60;
+		s->_20ms_epoch = f->_20ms_epoch;
 
 	if(f->set_z_count)
 		s->_z_count = f->z_count;
@@ -552,6 +637,10 @@ void Correlator::ProcessFeedback(Correlator_State_S *s, NCO_Command_S *f)
 		/* Clear out some buffers */
 		memset(s, 0x0, sizeof(Correlator_State_S));
 		memset(f, 0x0, sizeof(NCO_Command_S));
+
+		/* A channel just freed up, cut a sliced search short so the strong sweep gets to it */
+		if((pAcquisition->getType() == ACQ_TYPE_WEAK) || (pAcquisition->getType() == ACQ_TYPE_MEDIUM))
+			pAcquisition->Cancel();
 	}
 
 }
@@ -632,7 +721,7 @@ void Correlator::InitCorrelator(Correlator_State_S *s)
 	int32 bin, inc;
 	
 	/* Update delay based on current packet count */
-	dt = (double)packet.count - (double)result.count;
+	dt = (double)packet_tic - (double)result.count;
 	dt *= (double).001;
 	dt *= (double)result.doppler * (double)CODE_RATE/(double)L1;
 
@@ -51,9 +51,12 @@ class Correlator : public Threaded_Object
 
 		/* These variables are shared among all the channels */
 		Acq_Command_S 		result; 							//!< An acquisition result has been returned!
-		ms_packet			packet;								//!< 1ms of data
+		ms_packet			*packet;							//!< 1ms of data, borrowed from the FIFO
+		int32				packet_tic;							//!< FIFO count of the last packet correlated
+		int32				reader;								//!< FIFO cursor
 		int32				packet_count;						//!< Count 1ms packets
 		int32				measurement_tic;					//!< Measurement tic
+		uint32				measurements_sent;					//!< Measurement epochs sent to the PVT
 		CPX 				*main_sine_table;					//!< Hold the sine wipeoff table
 		CPX 				**main_sine_rows;					//!< Row pointers to above
 		MIX 		 		*main_code_table;					//!< Hold the PRN lookup table for all 32 SVs [2*CODE_BINS+1][2*SAMPS_MS];
@@ -66,7 +69,7 @@ class Correlator : public Threaded_Object
 		Correlator();
 		~Correlator();
 		void Import();											//!< Get IF data, NCO commands, and acq results
-		void Export();											//!< Dump results to channels and Navigation
+		void Export();											//!< Hand the packet back to the FIFO
 		void Start();											//!< Start the thread
 		void Correlate();										//!< Run the actual correlation
 		void SamplePRN();																	//!< Sample all 32 PRN codes and put it into the code table
@@ -74,10 +77,13 @@ class Correlator : public Threaded_Object
 		void InitCorrelator(Correlator_State_S *s);											//!< Initialize a correlator/channel with an acquisition result
 		void UpdateState(Correlator_State_S *s, int32 samps);								//!< Update correlator state
 		void ProcessFeedback(Correlator_State_S *s, NCO_Command_S *f);						//!< Process the feedback
-		void DumpAccum(Correlator_State_S *s, Correlation_S *c, NCO_Command_S *f, int32 _chan);	//!< Dump accumulation to channel for processing
+		void DumpAccum(Correlator_State_S *s, Correlation_S *c, int32 _chan);				//!< Dump accumulation to channel for processing
+		void FinishDump(Correlator_State_S *s, Correlation_S *c, NCO_Command_S *f, int32 _chan);	//!< Get the channel's feedback once the loops are closed, and apply it
 		void TakeMeasurements();																//!< Take some measurements
 		void Accum(Correlator_State_S *s, Correlation_S *c, CPX *data, int32 samps);		//!< Do the actual accumulation
 		void SineGen(int32 samps);															//!< Dynamic wipeoff generation
+
+		int32 getTic(){return(packet->count);}					//!< FIFO count of the packet being correlated
 };
 
 #endif /* CORRELATOR_H_ */
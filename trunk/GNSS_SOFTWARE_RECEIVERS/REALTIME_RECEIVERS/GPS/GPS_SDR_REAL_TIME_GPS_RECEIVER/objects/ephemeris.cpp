@@ -170,7 +170,7 @@ void Ephemeris::Import()
 
 	/* Get the SV number */
 	sv = ephem_packet.sv;
-	if((sv < MAX_SV) && (sv >= 0))
+	if((sv < MAX_SV) && (sv >= 0) && Decode())
 	{
 
 		switch(ephem_packet.subframe)
@@ -296,6 +296,34 @@ void Ephemeris::Import()
 /*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Decode: The channel only checks the TLM and HOW words when it frames a subframe, check the parity of
+ * every word here and strip the D30* inversion from the data bits. False if any word fails.
+ * */
+bool Ephemeris::Decode()
+{
+
+	int32 lcv;
+	uint32 *word;
+
+	for(lcv = 0; lcv < FRAME_SIZE_PLUS_2; lcv++)
+	{
+		word = &ephem_packet.word_buff[lcv];
+
+		if(!gps_parity(*word))
+			return(false);
+
+		if(*word & 0x40000000)
+			*word ^= 0x3FFFFFC0;
+	}
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
 /*----------------------------------------------------------------------------------------------*/
 int32 sbit(uint32 val, int32 nbits)
 {
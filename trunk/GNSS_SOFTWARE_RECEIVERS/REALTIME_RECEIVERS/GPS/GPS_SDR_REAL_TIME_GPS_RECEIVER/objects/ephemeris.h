@@ -58,6 +58,7 @@ class Ephemeris : public Threaded_Object
 		~Ephemeris();
 		void Import();							//!< Read data from channels
 		void Start();							//!< Start the thread
+		bool Decode();							//!< Check the parity of a subframe and un-invert its data
 		void Parse(int32 _sv);					//!< Parse data message into decimal values
 		void ParseUTC();						//!< Parse the UTC values
 		void ParseHealth();						//!< Parse page 24 of SF 4 and 5 for SV Health codes
@@ -25,6 +25,8 @@
  */
 /*----------------------------------------------------------------------------------------------*/
 
+#include <sys/mman.h>
+
 #include "fifo.h"
 
 /*----------------------------------------------------------------------------------------------*/
@@ -65,30 +67,29 @@ void FIFO::Start()
 FIFO::FIFO():Threaded_Object("FIFTASK")
 {
 
-	int32 lcv;
-
 	/* Create the buffer */
-	buff = new ms_packet[FIFO_DEPTH];
-	memset(buff, 0x0, sizeof(ms_packet)*FIFO_DEPTH);
-	head = &buff[0];
-	tail = &buff[0];
-
-	/* Create circular linked list */
-	for(lcv = 0; lcv < FIFO_DEPTH-1; lcv++)
-		buff[lcv].next = &buff[lcv+1];
-
-	buff[FIFO_DEPTH-1].next = &buff[0];
+	depth = gopt.fifo_depth;
+	Allocate();
 
 	tic = count = 0;
+	fill = fill_hi = 0;
+	fill_lo = depth;
+	fill_reset = 0;
 
-	sem_init(&sem_full, NULL, 0);
-	sem_init(&sem_empty, NULL, FIFO_DEPTH);
+	memset(&cursors[0], 0x0, sizeof(FIFO_Cursor_S)*FIFO_READERS);
+
+	/* The acquisition snapshot is a lossless reader that is only active while pinned */
+	pin = -1;
+	pin = Register(depth, true);
+	cursors[pin].active = false;
+	pin_count = pin_len = 0;
 
 	pSource = NULL;
 	ResetSource();
 
 	if(gopt.verbose)
-		fprintf(stdout,"Creating FIFO\n");
+		fprintf(stdout,"Creating FIFO, %d ms in %d MB (%s)\n",depth,(int32)(buff_size >> 20),
+			(huge == 2) ? "huge pages" : (huge == 1) ? "transparent huge pages" : "small pages");
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -97,12 +98,8 @@ FIFO::FIFO():Threaded_Object("FIFTASK")
 /*----------------------------------------------------------------------------------------------*/
 FIFO::~FIFO()
 {
-	int32 lcv;
 
-	sem_destroy(&sem_full);
-	sem_destroy(&sem_empty);
-
-	delete [] buff;
+	munmap(buff, buff_size);
 
 	if(pSource != NULL)
 		delete pSource;
@@ -114,55 +111,280 @@ FIFO::~FIFO()
 /*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Allocate: Map the buffer on 2 MB huge pages if the kernel has a pool of them, otherwise on normal
+ * pages with a hint for transparent huge pages. Either way it is prefaulted, so the sampler never takes
+ * a page fault on a fresh slot. Anonymous memory starts out zeroed.
+ * */
+void FIFO::Allocate()
+{
+
+	void *p;
+
+	buff_size = ((size_t)depth*sizeof(ms_packet) + FIFO_HUGE_PAGE - 1) & ~((size_t)FIFO_HUGE_PAGE - 1);
+	p = MAP_FAILED;
+	huge = 0;
+
+#ifdef MAP_HUGETLB
+	p = mmap(NULL, buff_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+	if(p != MAP_FAILED)
+		huge = 2;
+#endif
+
+	if(p == MAP_FAILED)
+	{
+		p = mmap(NULL, buff_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(p == MAP_FAILED)
+		{
+			fprintf(stderr,"Could not allocate the FIFO, aborting.\n");
+			exit(1);
+		}
+
+#ifdef MADV_HUGEPAGE
+		if(madvise(p, buff_size, MADV_HUGEPAGE) == 0)
+			huge = 1;
+#endif
+		memset(p, 0x0, buff_size);
+	}
+
+	buff = (ms_packet *)p;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
 /*----------------------------------------------------------------------------------------------*/
 void FIFO::Import()
 {
 
+	ms_packet *p;
+	int32 lcv;
+
 	IncStartTic();
 
-	/* Read from the GPS source */
+	/* Wait for the lossless readers (and a pinned snapshot) to free a slot */
+	fill = Backlog();
+	while(fill >= depth)
+	{
+		usleep(100);
+		fill = Backlog();
+	}
+
+	/* Water marks, restarted whenever the telemetry has read them */
+	if(fill_reset)
+	{
+		fill_hi = fill_lo = fill;
+		fill_reset = 0;
+	}
+	if(fill > fill_hi)
+		fill_hi = fill;
+	if(fill < fill_lo)
+		fill_lo = fill;
+
+	/* Read from the GPS source straight into the slot, a file source may point the slot at its mapping */
+	p = &buff[count % depth];
+	for(lcv = 0; lcv < MAX_ANTENNAS; lcv++)
+		p->payload[lcv] = &p->data[lcv][0];
+
 	if(pSource != NULL)
-		pSource->Read(head);
+		pSource->Read(p);
+
+	IncStopTic();
 
 	Enqueue();
 
-	IncStopTic();
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Enqueue: Publish the slot at count, the payload must be written before the index (release).
+ * */
+void FIFO::Enqueue()
+{
+
+	buff[count % depth].count = count;
+
+	FIFO_BARRIER();
 
 	count++;
+	gclock = count;
 
 }
 /*----------------------------------------------------------------------------------------------*/
 
 
 /*----------------------------------------------------------------------------------------------*/
-void FIFO::Enqueue()
+int32 FIFO::Backlog()
 {
 
-	sem_wait(&sem_empty);
+	int32 lcv, behind, worst;
+
+	worst = 0;
+	for(lcv = 0; lcv < FIFO_READERS; lcv++)
+	{
+		if(cursors[lcv].active && cursors[lcv].lossless)
+		{
+			behind = count - cursors[lcv].tail;
+			if(behind > worst)
+				worst = behind;
+		}
+	}
+
+	return(worst);
 
-	head->count = count;
+}
+/*----------------------------------------------------------------------------------------------*/
 
-	/* Send a packet to the acquisition (nonblocking) */
-	write(COR_2_ACQ_P[WRITE], head, sizeof(ms_packet));
 
-	head = head->next;
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Register: Add a reader, it starts with the next packet to be produced. A lossy reader's _lag is
+ * clamped to half the FIFO so it can never be reading the slot being refilled. Returns -1 if all
+ * cursors are taken.
+ * */
+int32 FIFO::Register(int32 _lag, bool _lossless)
+{
+
+	int32 lcv;
+	FIFO_Cursor_S *c;
 
-	sem_post(&sem_full);
+	if(!_lossless && (_lag > depth/2))
+		_lag = depth/2;
+
+	Lock();
+
+	for(lcv = 0; lcv < FIFO_READERS; lcv++)
+	{
+		c = &cursors[lcv];
+		if(!c->active && (lcv != pin))
+		{
+			c->lossless = _lossless;
+			c->lag = _lag;
+			c->overruns = 0;
+			c->tail = count;
+
+			FIFO_BARRIER();
+
+			c->active = true;
+			break;
+		}
+	}
+
+	Unlock();
+
+	if(lcv == FIFO_READERS)
+	{
+		if(gopt.verbose)
+			fprintf(stdout,"FIFO out of reader cursors\n");
+		return(-1);
+	}
+
+	return(lcv);
 
 }
 /*----------------------------------------------------------------------------------------------*/
 
 
 /*----------------------------------------------------------------------------------------------*/
-void FIFO::Dequeue(ms_packet *p)
+void FIFO::Unregister(int32 _reader)
 {
 
-	sem_wait(&sem_full);
+	Lock();
 
-	memcpy(p, tail, sizeof(ms_packet));
-	tail = tail->next;
+	cursors[_reader].active = false;
 
-	sem_post(&sem_empty);
+	Unlock();
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Dequeue: Borrow the reader's next packet. The slot is owned by the caller until Retire() is called,
+ * the index must be read before the payload (acquire). A lossy reader that has fallen more than its
+ * lag behind is moved up to the newest packet, the skipped packets are counted as overruns. Returns
+ * NULL if the receiver stops while waiting, there is then nothing to Retire().
+ * */
+ms_packet *FIFO::Dequeue(int32 _reader)
+{
+
+	FIFO_Cursor_S *c = &cursors[_reader];
+	int32 behind;
+
+	while((count == c->tail) && grun)
+		usleep(100);
+
+	if(count == c->tail)
+		return(NULL);
+
+	FIFO_BARRIER();
+
+	behind = count - c->tail;
+	if(!c->lossless && (behind > c->lag))
+	{
+		c->overruns += behind - 1;
+		c->tail = count - 1;
+	}
+
+	return(&buff[c->tail % depth]);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Retire: Return the borrowed packet, all reads of it must complete before the index moves (release).
+ * For a lossy reader the producer may have reached the slot in the meantime, in which case the packet
+ * is counted as an overrun and false is returned so the data can be discarded.
+ * */
+bool FIFO::Retire(int32 _reader)
+{
+
+	FIFO_Cursor_S *c = &cursors[_reader];
+	bool valid;
+
+	FIFO_BARRIER();
+
+	valid = c->lossless || ((count - c->tail) < (depth - 1));
+	if(!valid)
+		c->overruns++;
+
+	c->tail++;
+
+	return(valid);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+int32 FIFO::getOverruns(int32 _reader)
+{
+
+	return(cursors[_reader].overruns);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * getFill: The backlog is how many packets the slowest lossless reader (or the snapshot) is holding,
+ * the producer stalls once it reaches the depth. Reading the water marks restarts them.
+ * */
+void FIFO::getFill(int32 *_fill, int32 *_hi, int32 *_lo)
+{
+
+	*_fill = fill;
+	*_hi = fill_hi;
+	*_lo = fill_lo;
+
+	fill_reset = 1;
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -185,3 +407,66 @@ void FIFO::ResetSource()
 }
 /*----------------------------------------------------------------------------------------------*/
 
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Snapshot: Pin the next _ms packets to be produced and block until they have all arrived. The
+ * packets are then read in place via getSnapshot() until Release() is called, no copies are made.
+ * The snapshot is held by a lossless cursor, so the producer only stalls if it would lap it (depth
+ * ms later). Off the sample clock the snapshot starts at the slowest reader (the correlator) instead of
+ * the newest packet, so it lands on the same samples every run. A snapshot longer than the FIFO could
+ * never be held, that is a configuration error.
+ * */
+int32 FIFO::Snapshot(int32 _ms)
+{
+
+	if(_ms > depth)
+	{
+		fprintf(stderr,"FIFO snapshot of %d ms exceeds the %d ms depth, aborting.\n",_ms,depth);
+		exit(1);
+	}
+
+	Lock();
+
+	pin_len = _ms;
+	pin_count = gopt.realtime ? count : (count - Backlog());
+	cursors[pin].tail = pin_count;
+
+	FIFO_BARRIER();
+
+	cursors[pin].active = true;
+
+	Unlock();
+
+	/* Wait for the packets to arrive */
+	while((count < (pin_count + pin_len)) && grun)
+		usleep(1000);
+
+	return(pin_count);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+ms_packet *FIFO::getSnapshot(int32 _ms)
+{
+
+	return(&buff[(pin_count + _ms) % depth]);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void FIFO::Release()
+{
+
+	Lock();
+
+	cursors[pin].active = false;
+
+	Unlock();
+
+}
+/*----------------------------------------------------------------------------------------------*/
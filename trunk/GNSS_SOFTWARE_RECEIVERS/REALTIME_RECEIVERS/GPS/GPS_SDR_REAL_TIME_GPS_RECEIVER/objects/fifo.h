@@ -31,25 +31,65 @@
 #include "includes.h"
 #include "gps_source.h"
 
-#define FIFO_DEPTH (4000)	//!< In ms
+#define FIFO_DEPTH (4000)	//!< Default depth, in ms
+#define FIFO_MIN_DEPTH (1024)	//!< Smallest depth -fifo accepts, the 310 ms weak snapshot plus time for the producer
+								//!< to run ahead while a strong search holds its pin
+#define FIFO_HUGE_PAGE (2<<20)	//!< Back the buffer with pages this big where the kernel has them
+#define FIFO_LINE	(64)	//!< Cache line size, keeps the producer and consumer indices apart
+#define FIFO_READERS (8)	//!< Maximum number of registered readers
+
+/* x86 does not reorder stores with stores or loads with loads, so acquire/release on the ring
+ * indices only needs to stop the compiler from reordering */
+#define FIFO_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/*! \ingroup STRUCTS
+ *  @brief A reader of the FIFO, padded to a cache line so readers never share one */
+typedef struct FIFO_Cursor_S
+{
+
+	volatile int32 tail;		//!< Count of the next packet to be borrowed, only the reader writes this
+	volatile int32 active;		//!< Cursor is registered
+	volatile int32 overruns;	//!< Packets this reader lost to the producer
+	int32 lossless;				//!< The producer waits for this reader rather than overrun it
+	int32 lag;					//!< How far (ms) a lossy reader may fall behind before skipping ahead
+	char pad[FIFO_LINE - 5*sizeof(int32)];
+
+} FIFO_Cursor_S;
 
 /*! \ingroup CLASSES
- *
+ *  @brief Lock free single producer/multiple reader broadcast ring of 1 ms packets. The producer (this
+ *  thread) fills the slot at count, each reader registers a cursor, borrows the slot at its own tail in
+ *  place and hands it back with Retire(). Only lossless readers can stall the producer, lossy readers
+ *  that fall behind are skipped forward and their overruns counted.
  */
 class FIFO : public Threaded_Object
 {
 
 	private:
 
-		sem_t sem_full;
-		sem_t sem_empty;
+		ms_packet *buff;	//!< depth buffer (in 1 ms packets)
+		int32 depth;		//!< Number of packets in the buffer
+		size_t buff_size;	//!< Size of the mapping
+		int32 huge;			//!< 2 if backed by hugetlbfs pages, 1 if by transparent huge pages, 0 if neither
 
-		ms_packet *buff;	//!< 1 second buffer (in 1 ms packets)
-		ms_packet *head;	//!< Pointer to the head
-		ms_packet *tail;	//!< Pointer to the tail
+		char pad0[FIFO_LINE];
+		volatile int32 count;		//!< Count the number of packets received, only the producer writes this
+		char pad1[FIFO_LINE];
+		FIFO_Cursor_S cursors[FIFO_READERS];	//!< The readers
 
-		int32 count;		//!< Count the number of packets received
-		int32 tic;			//!< Master receiver tic
+		int32 tic;					//!< Master receiver tic
+
+		int32 pin;					//!< Cursor used for the acquisition snapshot
+		volatile int32 pin_count;	//!< Packet count of the first pinned packet
+		int32 pin_len;				//!< Number of pinned packets (ms)
+
+		int32 fill;					//!< Backlog at the last Import()
+		int32 fill_hi;				//!< Largest backlog since the last getFill()
+		int32 fill_lo;				//!< Smallest backlog since the last getFill()
+		volatile int32 fill_reset;	//!< Set by getFill(), the producer restarts the water marks
+
+		int32 Backlog();			//!< Packets held by the slowest lossless reader
+		void Allocate();			//!< Map the buffer
 
 	public:
 
@@ -61,8 +101,20 @@ class FIFO : public Threaded_Object
 
 		void Open();
 		void Enqueue();
-		void Dequeue(ms_packet *p);
+		int32 Register(int32 _lag, bool _lossless);	//!< Add a reader starting at the newest packet, returns its cursor
+		void Unregister(int32 _reader);				//!< Remove a reader
+		ms_packet *Dequeue(int32 _reader);			//!< Borrow the next packet in place, blocks until one is available (NULL once stopped)
+		bool Retire(int32 _reader);					//!< Hand the borrowed packet back, false if it was overrun while held
+		int32 getOverruns(int32 _reader);			//!< Packets this reader has lost
+		int32 getDepth(){return(depth);}			//!< Number of packets in the buffer
+		int32 getHuge(){return(huge);}				//!< How the buffer is backed
+		void getFill(int32 *_fill, int32 *_hi, int32 *_lo);	//!< Backlog now and its water marks since the last call
+		int32 getLag(int32 _reader){return(count - cursors[_reader].tail);}	//!< Packets produced that this reader has yet to retire
 		void ResetSource();
+
+		int32 Snapshot(int32 _ms);				//!< Pin the next _ms packets and wait for them to arrive, returns count of the first
+		ms_packet *getSnapshot(int32 _ms);		//!< Read-only view of the _ms'th pinned packet
+		void Release();							//!< Unpin the snapshot
 };
 
 #endif /* FIFO_H */
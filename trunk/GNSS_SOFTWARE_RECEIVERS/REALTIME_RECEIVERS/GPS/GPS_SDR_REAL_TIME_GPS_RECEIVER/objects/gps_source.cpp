@@ -26,16 +26,18 @@
 /*----------------------------------------------------------------------------------------------*/
 
 
+#include <sys/mman.h>
+
 #include "gps_source.h"
 
 
 /*----------------------------------------------------------------------------------------------*/
 GPS_Source::GPS_Source(Options_S *_opt)
 {
-	int i;
+
+	int32 lcv;
 
 	memcpy(&opt, _opt, sizeof(Options_S));
-	record_on = (opt.recorder==1);
 	switch(opt.source)
 	{
 		case SOURCE_USRP_V1:
@@ -54,46 +56,29 @@ GPS_Source::GPS_Source(Options_S *_opt)
 			source_type = SOURCE_FILE;
 			Open_GPS_File();
 			break;
+		case SOURCE_STREAM:
+			source_type = SOURCE_STREAM;
+			Open_Stream();
+			break;
 		default:
 			source_type = SOURCE_USRP_V1;
 			Open_USRP_V1();
 			break;
 	}
 
-	overflw = soverflw = 0;
-	agc_scale = 1;
+	memset(overflw, 0x0, sizeof(overflw));
+	memset(soverflw, 0x0, sizeof(soverflw));
+	memset(agc_hist, 0x0, sizeof(agc_hist));
+	for(lcv = 0; lcv < MAX_ANTENNAS; lcv++)
+		agc_scale[lcv] = 1;
 
 	/* Assign to base */
 	buff_out_p = &buff_out[0];
 	ms_count = 0;
 	
 
-	if(record_on)
-	{
-		// init record files
-		
-		out_file_a = fopen("./data.dba","wb");
-		if(out_file_a != NULL) fprintf(stdout,"data.dba opened\n");
-		if(opt.mode) // dual board
-		{
-
-			out_file_b = fopen("./data.dbb","wb");
-			if(out_file_b != NULL) fprintf(stdout,"data.dbb opened\n");
-		}		
-		fflush(stdout);
-
-	}
-
-
 	if(opt.verbose)
 		fprintf(stdout,"Creating GPS Source\n");
-
-	for (i=0; i<1024; i=i+1) {
-		sin_table[i] = -8*sin(2*M_PI*i/1024);
-		cos_table[i] = +8*cos(2*M_PI*i/1024);
-	}
-	phase = 0;//2*M_PI*3889200/16000000;
-	delta_phase = unsigned(2557223528);
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -116,6 +101,9 @@ GPS_Source::~GPS_Source()
 		case SOURCE_FILE:
 			Close_GPS_File();
 			break;
+		case SOURCE_STREAM:
+			Close_Stream();
+			break;
 		default:
 			Close_USRP_V1();
 			break;
@@ -124,9 +112,6 @@ GPS_Source::~GPS_Source()
 	if(opt.verbose)
 		fprintf(stdout,"Destructing GPS Source\n");
 
-
-
-	fclose(out_file_a);
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -136,8 +121,9 @@ void GPS_Source::Read(ms_packet *_p)
 {
 
 	double gain;
-	int32 shift;
-	CPX agc_buff[SAMPS_MS];
+	int32 lcv, ants;
+	db_dbs_rx *dbs;
+
 	switch(source_type)
 	{
 		case SOURCE_USRP_V1:
@@ -156,6 +142,9 @@ void GPS_Source::Read(ms_packet *_p)
 		case SOURCE_FILE:
 			Read_GPS_File(_p);
 			break;
+		case SOURCE_STREAM:
+			Read_Stream(_p);
+			break;
 		default:
 			Read_USRP_V1(_p);
 			break;
@@ -164,51 +153,43 @@ void GPS_Source::Read(ms_packet *_p)
 
 	}
 
-	if( record_on && (source_type != SOURCE_FILE) )
+	switch(source_type)
 	{
+		case SOURCE_USRP_V1:
 
-		fwrite (&_p->data[0][0] , sizeof(CPX) , SAMPS_MS , out_file_a );
-
-		if(opt.mode)
-		{
-			fwrite(&_p->data[1][0],sizeof(CPX),SAMPS_MS, out_file_b);
-		}
-
-	}
-
+			ants = (opt.mode == 0) ? 1 : 2;
 
+			for(lcv = 0; lcv < ants; lcv++)
+			{
+				/* Count the overflows and shift if needed */
+				soverflw[lcv] += sse_agc(&_p->data[lcv][0], SAMPS_MS, AGC_BITS, 6);
 
-	//TODO: FIX THE AGC FOR MULTI INPUT STUFZ
+				/* Figure out the agc_scale value */
+				if((ms_count & (AGC_PERIOD - 1)) == 0)
+				{
+					dbs = (lcv == 0) ? dbs_rx_a : dbs_rx_b;
 
+					if(dbs != NULL)
+					{
+						gain = dbs->rf_gain();
 
-	switch(source_type)
-	{
-		case SOURCE_USRP_V1:
-			
-			/* Count the overflows and shift if needed */
-			soverflw += run_agc(&_p->data[0][0], SAMPS_MS, AGC_BITS, 6);
-			
-			/* Figure out the agc_scale value */
-			if((ms_count & 0xFF) == 0)
-			{
-				gain = dbs_rx_a->rf_gain();
+						if(soverflw[lcv] > OVERFLOW_HIGH)
+							gain -= 0.5;
 
-				if(soverflw > OVERFLOW_HIGH)
-					gain -= 0.5;
+						if(soverflw[lcv] < OVERFLOW_LOW)
+							gain += 0.5;
 
-				if(soverflw < OVERFLOW_LOW)
-					gain += 0.5;
+						dbs->rf_gain(gain);
 
-				dbs_rx_a->rf_gain(gain);
+						agc_scale[lcv] = (int32)floor(2.0*(dbs->max_rf_gain() - gain));
+					}
 
-				agc_scale = (int32)floor(2.0*(dbs_rx_a->max_rf_gain() - gain));
+					::agc_hist(&_p->data[lcv][0], SAMPS_MS, AGC_BITS, agc_hist[lcv]);
 
-				overflw = soverflw;
-				soverflw = 0;
+					overflw[lcv] = soverflw[lcv];
+					soverflw[lcv] = 0;
+				}
 			}
-			
-
-
 
 			break;
 		case SOURCE_USRP_V2:
@@ -238,8 +219,10 @@ void GPS_Source::Open_USRP_V1()
 
 	double ddc_correct_a = 0;
 	double ddc_correct_b = 0;
+	int32 up, down, tmp;
 
 	leftover = 0;
+	dbs_rx_a = dbs_rx_b = NULL;
 
 	if(opt.f_sample == 65.536e6)
 	{
@@ -269,6 +252,18 @@ void GPS_Source::Open_USRP_V1()
 		}
 	}
 
+	/* Resample whatever rate the USRP runs at to 2.048 Msps, up/down reduced by their gcd */
+	usrp_samps_ms = (int32)floor(opt.f_sample/opt.decimate/1e3);
+	up = SAMPS_MS; down = usrp_samps_ms;
+	while(down != 0)
+	{
+		tmp = up % down;
+		up = down;
+		down = tmp;
+	}
+	usrp_rs = new Resampler(SAMPS_MS/up, usrp_samps_ms/up, USRP_TAPS, (opt.mode == 0) ? 1 : 2, usrp_samps_ms,
+		1024.0/(double)usrp_samps_ms);
+
 	/* Make the URX */
 //Art!!! urx = usrp_standard_rx::make(0, opt.decimate, 1, -1, 0, 0, 0);
 	urx = NULL;
@@ -418,24 +413,39 @@ void GPS_Source::Open_USRP_V1()
 
 
 /*----------------------------------------------------------------------------------------------*/
+/*!
+ * Open_GN3S: Besides starting the sampler this builds the front end. The mixer is a table of every
+ * (NCO phase, 2 bit sample) product, so mixing is one lookup per sample, followed by a GN3S_UP/GN3S_DOWN
+ * polyphase resampler.
+ * */
 void GPS_Source::Open_GN3S()
 {
 	unsigned char bbbb[4];
 
-	int32 lcv;
-	const double mul = 8.1838e6/2.048e6;
-	//const double mul = 16e6/2.048e6;
+	int32 lcv, tap;
+	int16 LUT[4] = {-3, -1, 1, 3};
+	double theta;
 
-	/* Create the object */
-	gn3s_a = new gn3s(0);
+	/* Create the object, the sample ring is sized in USB blocks */
+	gn3s_a = new gn3s(0, opt.gn3s_sim, opt.file_pace, opt.usb_blocks);
+	gn3s_overruns = 0;
 
-	/* Create decimation lookup table */
-	for(lcv = 0; lcv < 10240; lcv++)
+	/* Mixer table, the same rotation the old sin/cos tables did */
+	phase = 0;
+	delta_phase = unsigned(2557223528);
+
+	for(lcv = 0; lcv < (1 << GN3S_NCO_BITS); lcv++)
 	{
-		//gdec[lcv] = (int32)floor((double)lcv * mul);
-		gdec[lcv] = (int32)floor((lcv+1)*4000/2048);
+		theta = 2*M_PI*(double)lcv/(double)(1 << GN3S_NCO_BITS);
+		for(tap = 0; tap < 4; tap++)
+		{
+			gn3s_lut[(lcv << 2) | tap].i = (int16)floor(GN3S_MIX_AMP*LUT[tap]*cos(theta) + 0.5);
+			gn3s_lut[(lcv << 2) | tap].q = (int16)floor(-GN3S_MIX_AMP*LUT[tap]*sin(theta) + 0.5);
+		}
 	}
 
+	gn3s_rs = new Resampler(GN3S_UP, GN3S_DOWN, GN3S_TAPS, 1, 20000, GN3S_FIR_CUTOFF/(1000.0*GN3S_SAMPS_MS));
+
 
 	//fprintf(stdout, "Writing command words! /n");
     bbbb[0] = 0xA2; bbbb[1] = 0x91; bbbb[2] = 0x8F; bbbb[3] = 0x30;
@@ -459,7 +469,8 @@ void GPS_Source::Open_GN3S()
     bbbb[0] = 0x14; bbbb[1] = 0xC0; bbbb[2] = 0x40; bbbb[3] = 0x29;
     gn3s_a->write_cmd(0x0C, 0, 0, bbbb, 4);
 
-
+	/* Drain the endpoint into the sample ring from here on */
+	gn3s_a->Start();
 
 	/* Everything is super! */
 	fprintf(stdout,"GN3S Start\n");
@@ -469,25 +480,94 @@ void GPS_Source::Open_GN3S()
 
 
 /*----------------------------------------------------------------------------------------------*/
+/*!
+ * Open_GPS_File: The recordings are memory mapped FILE_WINDOW_MS at a time (they are far too large to
+ * map whole in a 32 bit process). Raw 16 bit files are played in place, the FIFO slots point straight
+ * into the mapping. Packed files (with an IF_File_Header_S) are unpacked into the slots instead.
+ * */
 void GPS_Source::Open_GPS_File()
 {
-	
 
-	fp_a = fopen(opt.file_name_1,"rb");	
-	rewind(fp_a);
-	
+	int32 lcv, bits, data;
+	int64 len;
+	char *name;
+	IF_File_Header_S header;
+
+	file_ants = (opt.mode == 1) ? 2 : 1;
+	file_ms = -1;
+	file_bits = 16;
 
-	if( opt.mode == 1)
+	for(lcv = 0; lcv < file_ants; lcv++)
 	{
-		fp_b = fopen(opt.file_name_2,"rb");
-		//note only run dual file for same time as single
-		rewind(fp_b);
+		name = (lcv == 0) ? opt.file_name_1 : opt.file_name_2;
+
+		file_fd[lcv] = open(name, O_RDONLY | O_LARGEFILE);
+		if(file_fd[lcv] == -1)
+		{
+			fprintf(stderr,"Could not open GPS data file %s, aborting.\n",name);
+			exit(1);
+		}
+
+		/* Look for a header, both files must agree */
+		memset(&header, 0x0, sizeof(IF_File_Header_S));
+		bits = 16;
+		data = 0;
+		if((pread(file_fd[lcv], &header, sizeof(IF_File_Header_S), 0) == sizeof(IF_File_Header_S)) &&
+		   (header.magic == IF_FILE_MAGIC))
+		{
+			bits = header.bits;
+			data = sizeof(IF_File_Header_S);
+			if((header.version != IF_FILE_VERSION) || (header.samps_ms != SAMPS_MS) ||
+			   ((bits != 2) && (bits != 4) && (bits != 8) && (bits != 16)))
+			{
+				fprintf(stderr,"Unsupported GPS data file %s, aborting.\n",name);
+				exit(1);
+			}
+		}
+
+		if((lcv > 0) && ((bits != file_bits) || (data != file_data)))
+		{
+			fprintf(stderr,"GPS data files have different formats, aborting.\n");
+			exit(1);
+		}
+
+		file_bits = bits;
+		file_data = data;
+		file_bytes_ms = SAMPS_MS*2*file_bits/8;
+
+		/* Only play as much as the shortest file holds */
+		len = (lseek64(file_fd[lcv], 0, SEEK_END) - file_data)/file_bytes_ms;
+		if((file_ms == -1) || (len < file_ms))
+			file_ms = len;
 	}
 
-	//TODO: add some bulletproofing incase the file doesnt open
+	file_start = (int64)floor(opt.file_offset*1000.0);
+	if((file_start < 0) || (file_start >= file_ms))
+	{
+		fprintf(stderr,"Offset of %.3f s is outside the %.3f s GPS data file, aborting.\n",opt.file_offset,(double)file_ms/1000.0);
+		exit(1);
+	}
 
+	file_end = file_ms;
+	if(opt.file_duration > 0)
+		file_end = file_start + (int64)floor(opt.file_duration*1000.0);
+	if(file_end > file_ms)
+		file_end = file_ms;
+
+	memset(file_base, 0x0, sizeof(file_base));
+	memset(file_map, 0x0, sizeof(file_map));
+	memset(file_len, 0x0, sizeof(file_len));
+	for(lcv = 0; lcv < FILE_MAPS; lcv++)
+		file_slot_win[lcv] = -1;
+	file_win = -1;
+	file_cur = 0;
+
+	file_pos = file_start;
+	file_played = 0;
+
+	if(opt.verbose)
+		fprintf(stdout,"Playing ms %lld to %lld of %lld (%d bit)\n",file_start,file_end,file_ms,file_bits);
 
-	return;
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -513,6 +593,8 @@ void GPS_Source::Close_USRP_V1()
 	if(urx != NULL)
 		delete urx;
 
+	delete usrp_rs;
+
 	if(opt.verbose)
 		fprintf(stdout,"Destructing USRP\n");
 
@@ -527,6 +609,8 @@ void GPS_Source::Close_GN3S()
 	if(gn3s_a != NULL)
 		delete gn3s_a;
 
+	delete gn3s_rs;
+
 	if(opt.verbose)
 		fprintf(stdout,"Destructing GN3S\n");
 
@@ -537,13 +621,17 @@ void GPS_Source::Close_GN3S()
 /*----------------------------------------------------------------------------------------------*/
 void GPS_Source::Close_GPS_File()
 {
-	fclose(fp_a);	
-	if( opt.mode == 1 )
+
+	int32 lcv, slot;
+
+	for(lcv = 0; lcv < file_ants; lcv++)
 	{
-		fclose(fp_b);
-	}
-	return;
+		for(slot = 0; slot < FILE_MAPS; slot++)
+			if(file_base[slot][lcv] != NULL)
+				munmap(file_base[slot][lcv], file_len[slot]);
 
+		close(file_fd[lcv]);
+	}
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -688,10 +776,7 @@ void GPS_Source::Read_GN3S(ms_packet *_p)
 	bool overrun;
 	int32 ms_mod5;
 	int32 lcv;
-	//int16 LUT[4] = {1, -1, 1, -1};
-	int16 LUT[4] = {-3, -1, 1, 3};
-	int16 *pbuff;
-	CPX mine_iq;
+	CPX *pbuff;
 
 	ms_mod5 = ms_count % 5;
 
@@ -729,14 +814,12 @@ void GPS_Source::Read_GN3S(ms_packet *_p)
 		/*for(lcv = 0; lcv < 40919*2; lcv++)
 			pbuff[lcv] = LUT[gbuff[lcv] & 0x3];*/
 
-		for(lcv = 0; lcv < 20000; lcv++){
-			short_phase = phase >> 22;
-//			mine_iq.i = (LUT[gbuff[lcv] & 0x03] * sin_table[short_phase]);
-//			mine_iq.q = (LUT[gbuff[lcv] & 0x03] * cos_table[short_phase]);
-			mine_iq.q = (LUT[gbuff[lcv] & 0x03] * sin_table[short_phase]);
-			mine_iq.i = (LUT[gbuff[lcv] & 0x03] * cos_table[short_phase]);
-			buff[lcv] = mine_iq;
-			phase = phase + delta_phase;
+		/* Mix, one table lookup per sample */
+		pbuff = &buff[0];
+		for(lcv = 0; lcv < 20000; lcv++)
+		{
+			pbuff[lcv] = gn3s_lut[((phase >> (32 - GN3S_NCO_BITS)) << 2) | (gbuff[lcv] & 0x3)];
+			phase += delta_phase;
 		}
 
 		/* Filter & decimate the data to regain bit precision */
@@ -745,15 +828,16 @@ void GPS_Source::Read_GN3S(ms_packet *_p)
 		/* Move last 7 elements to the bottom */
 		//memcpy(&buff[0], &buff[40919], 7*sizeof(CPX));
 
-		/* Check the overrun */
-/*		overrun = gn3s_a->check_rx_overrun();
+		/* Check the overrun, the streaming thread drops blocks if we fall behind */
+		overrun = (gn3s_a->getOverruns() != gn3s_overruns);
+		gn3s_overruns = gn3s_a->getOverruns();
 		if(overrun && opt.verbose)
 		{
 			time(&rawtime);
 			timeinfo = localtime (&rawtime);
 			fprintf(stdout, "GN3S overflow at time %s\n", asctime(timeinfo));
 			fflush(stdout);
-		}*/
+		}
 
 //		fwrite (buff_out, sizeof(CPX) , 10240 , out_file_a );
 	}
@@ -769,94 +853,196 @@ void GPS_Source::Read_GN3S(ms_packet *_p)
 
 
 /*----------------------------------------------------------------------------------------------*/
-void GPS_Source::Read_GPS_File(ms_packet *_p)
+/*!
+ * Map_GPS_File: Make window _win of each file current. A window that stops being current stays mapped
+ * until opt.fifo_depth more ms have been played, FIFO slots, the recorder, and an acquisition snapshot
+ * can all still point into it until then. As every window but the first and last played is longer than
+ * the FIFO, at most FILE_MAPS are ever needed, even when a short last window loops back to the start.
+ * A window that is still mapped is reused. The header shifts the samples off the page grid, so the
+ * mapping starts at the page below and file_map skips the difference.
+ * */
+void GPS_Source::Map_GPS_File(int32 _win)
 {
-	
-	
 
-	
-	fread(file_buff,sizeof(CPX),SAMPS_MS,fp_a);
+	int32 lcv, slot, free;
+	int64 first, len, offset, skip;
+	void *p;
+
+	first = (int64)_win*FILE_WINDOW_MS;
+	len = file_ms - first;
+	if(len > FILE_WINDOW_MS)
+		len = FILE_WINDOW_MS;
+
+	offset = file_data + first*file_bytes_ms;
+	skip = offset % (int64)sysconf(_SC_PAGESIZE);
+	len = len*file_bytes_ms + skip;
+
+	/* Retire the current window, and drop any that no packet can still point into */
+	file_retired[file_cur] = file_played;
+
+	free = -1;
+	for(slot = 0; slot < FILE_MAPS; slot++)
+	{
+		if((file_slot_win[slot] != -1) && (file_slot_win[slot] != _win) &&
+		   (file_played - file_retired[slot] > opt.fifo_depth))
+		{
+			for(lcv = 0; lcv < file_ants; lcv++)
+			{
+				if(file_base[slot][lcv] != NULL)
+					munmap(file_base[slot][lcv], file_len[slot]);
+				file_base[slot][lcv] = NULL;
+			}
+			file_slot_win[slot] = -1;
+		}
 
-	memcpy(&_p->data[0][0], file_buff, SAMPS_MS*sizeof(CPX));
+		if(file_slot_win[slot] == _win)
+			break;
+
+		if((file_slot_win[slot] == -1) && (free == -1))
+			free = slot;
+	}
 
-	if( opt.mode == 2 )
+	if(slot < FILE_MAPS)
 	{
-		fread(buff,sizeof(CPX),SAMPS_MS,fp_b);
-		memcpy(&_p->data[1][0], file_buff, SAMPS_MS*sizeof(CPX));
+		file_cur = slot;
 	}
+	else
+	{
+		if(free == -1)
+		{
+			fprintf(stderr,"Out of GPS data file mappings, aborting.\n");
+			exit(1);
+		}
 
-	/* Copy to destination */
-	
+		file_cur = free;
+		file_slot_win[file_cur] = _win;
+		file_len[file_cur] = (size_t)len;
 
+		for(lcv = 0; lcv < file_ants; lcv++)
+		{
+			p = mmap64(NULL, (size_t)len, PROT_READ, MAP_SHARED, file_fd[lcv], offset - skip);
+			if(p == MAP_FAILED)
+			{
+				fprintf(stderr,"Could not map GPS data file, stopping.\n");
+				file_base[file_cur][lcv] = NULL;
+				grun = 0x0;
+				continue;
+			}
 
-	if(feof(fp_a))
-	{	//once we hit end of file do a rewind!
+			madvise(p, (size_t)len, MADV_SEQUENTIAL);	//The advice values are not flags
+			madvise(p, (size_t)len, MADV_WILLNEED);
+			file_base[file_cur][lcv] = p;
+		}
+	}
 
-		rewind(fp_a);
-		if( opt.mode == 2) rewind(fp_b);
-		fprintf(stdout,"Rewinding GPS Data File\n");
+	for(lcv = 0; lcv < file_ants; lcv++)
+	{
+		if(file_base[file_cur][lcv] != NULL)
+			file_map[lcv] = (uint8 *)file_base[file_cur][lcv] + skip;
+		else
+			file_map[lcv] = NULL;
 	}
 
+	file_win = _win;
 
-	usleep(1000); // force a nap so we don't bust through this in 2 sec
 }
-
 /*----------------------------------------------------------------------------------------------*/
 
 
-
-
 /*----------------------------------------------------------------------------------------------*/
-void GPS_Source::Resample_USRP_V1(CPX *_in, CPX *_out)
+/*!
+ * Read_GPS_File: Point the packet at the next ms of the mapping, no copy is made, or unpack packed
+ * samples into the packet. Without a duration
+ * the file loops back to the offset, otherwise the receiver stops at the end of the window. Playback is
+ * paced at opt.file_pace times real time, or unthrottled when it is 0.
+ * */
+void GPS_Source::Read_GPS_File(ms_packet *_p)
 {
 
-	CPX buff_a[4096]; /* Max size based on 65.536 or 64 Msps */
-	CPX buff_b[4096]; /* Max size based on 65.536 or 64 Msps */
-	int32 *p_a;
-	int32 *p_b;
-	int32 *p_in;
-	int32 *p_out, *p_out2;
-	int32 samps_ms;
-	int32 lcv;
+	int32 lcv, win;
+	uint8 *src;
+	struct timeval now;
+	double elapsed, target;
 
-	p_a = (int32 *)&buff_a[0];
-	p_b = (int32 *)&buff_b[0];
-	p_in = (int32 *)_in;
-	p_out = (int32 *)_out;
-	p_out2 = (int32 *)&_out[2048];
-	samps_ms = (int32)floor(opt.f_sample/opt.decimate/1e3);
-
-	if(opt.mode == 0)
+	if(file_pos >= file_end)
 	{
-		/* Not much to do, just downsample from either 4.096 or 4.0 to 2.048e6 */
-		if(opt.f_sample != 65.536e6)
-			downsample(_out, _in, 2.048e6, opt.f_sample/opt.decimate, samps_ms);
-		else
+		if(opt.file_duration > 0)
 		{
-			for(lcv = 0; lcv < samps_ms; lcv += 2)
-				*p_out++ = p_in[lcv];
+			if(grun)
+				fprintf(stdout,"End of GPS data file\n");
+			grun = 0x0;
+			return;
 		}
+
+		//once we hit end of file do a rewind!
+		file_pos = file_start;
+		fprintf(stdout,"Rewinding GPS Data File\n");
 	}
-	else //!< 2 boards are being used, must first de-interleave data before downsampling
+
+	win = (int32)(file_pos/FILE_WINDOW_MS);
+	if(win != file_win)
+		Map_GPS_File(win);
+
+	for(lcv = 0; lcv < file_ants; lcv++)
 	{
+		if(file_map[lcv] == NULL)
+			continue;
 
-	/* De-interleave */
-		for(lcv = 0; lcv < samps_ms; lcv++)
+		src = &file_map[lcv][(file_pos - (int64)win*FILE_WINDOW_MS)*file_bytes_ms];
+
+		switch(file_bits)
 		{
-			p_a[lcv] = *p_in++;
-			p_b[lcv] = *p_in++;
-			
+			case 16:
+				_p->payload[lcv] = (CPX *)src;
+				break;
+			case 8:
+				sse_unpack8((int8 *)src, &_p->data[lcv][0], SAMPS_MS);
+				break;
+			case 4:
+				sse_unpack4(src, &_p->data[lcv][0], SAMPS_MS);
+				break;
+			default:
+				sse_unpack2(src, &_p->data[lcv][0], SAMPS_MS);
+				break;
 		}
-		
-		/* Downsample (and copy!) into appropriate location */
-		
-		
-		downsample(&_out[0],    buff_a, 2.048e6, opt.f_sample/opt.decimate, samps_ms);
-		downsample(&_out[2048], buff_b, 2.048e6, opt.f_sample/opt.decimate, samps_ms);
-		
-	
 	}
 
+	file_pos++;
+	file_played++;
+
+	/* Hold back to the requested rate */
+	if(opt.file_pace > 0)
+	{
+		if(file_played == 1)
+			gettimeofday(&file_t0, NULL);
+
+		gettimeofday(&now, NULL);
+		elapsed = (double)(now.tv_sec - file_t0.tv_sec)*1e6 + (double)(now.tv_usec - file_t0.tv_usec);
+		target = (double)file_played*1000.0/opt.file_pace;
+
+		if(target > elapsed)
+			usleep((useconds_t)(target - elapsed));
+	}
+
+}
+
+/*----------------------------------------------------------------------------------------------*/
+
+
+
+
+/*----------------------------------------------------------------------------------------------*/
+void GPS_Source::Resample_USRP_V1(CPX *_in, CPX *_out)
+{
+
+	CPX *out[2];
+
+	/* With 2 boards the input is interleaved, it is separated in the same pass as the filtering */
+	out[0] = &_out[0];
+	out[1] = &_out[2048];
+
+	usrp_rs->Run(_in, usrp_samps_ms, out);
+
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -932,13 +1118,93 @@ void GPS_Source::Resample_USRP_V1(CPX *_in, CPX *_out)
 
 void GPS_Source::Resample_GN3S(CPX *_in, CPX *_out)
 {
-	int i;
-    /* Process the array */
-	for(i = 0; i < 10240; i++)
+
+	CPX *out[1];
+
+	out[0] = _out;
+	gn3s_rs->Run(_in, 20000, out);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void GPS_Source::Open_Stream()
+{
+
+	stream = Sample_Source::Make(opt.stream_spec, (opt.mode == 1) ? 2 : 1);
+	if(stream == NULL)
 	{
-		_out[i] = _in[gdec[i]];
+		fprintf(stderr,"Could not open sample source %s, aborting.\n",opt.stream_spec);
+		exit(1);
 	}
 
-	return;
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void GPS_Source::Close_Stream()
+{
+
+	delete stream;
+
+	if(opt.verbose)
+		fprintf(stdout,"Destructing sample source\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void GPS_Source::Read_Stream(ms_packet *_p)
+{
+
+	if(!stream->Read(_p))
+	{
+		if(grun)
+			fprintf(stdout,"End of sample stream %s\n",stream->getName());
+		grun = 0x0;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 GPS_Source::getUSBBlocks()
+{
+
+	if(source_type == SOURCE_SIGE_GN3S)
+		return(gn3s_a->getBlocks());
+	else
+		return(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 GPS_Source::getUSBOverruns()
+{
+
+	if(source_type == SOURCE_SIGE_GN3S)
+		return(gn3s_a->getOverruns());
+	else
+		return(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 GPS_Source::getUSBErrors()
+{
+
+	if(source_type == SOURCE_SIGE_GN3S)
+		return(gn3s_a->getErrors());
+	else
+		return(0);
+
 }
 /*----------------------------------------------------------------------------------------------*/
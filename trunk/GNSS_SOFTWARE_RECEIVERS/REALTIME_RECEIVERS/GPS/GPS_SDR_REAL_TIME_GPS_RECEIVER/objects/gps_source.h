@@ -31,15 +31,48 @@
 #include "includes.h"
 #include "db_dbs_rx.h"
 #include "gn3s.h"
+#include "resampler.h"
+#include "sample_source.h"
 
 enum GPS_SOURCE_TYPE
 {
 	SOURCE_USRP_V1,
 	SOURCE_USRP_V2,
 	SOURCE_SIGE_GN3S,
-	SOURCE_FILE
+	SOURCE_FILE,
+	SOURCE_STREAM
 };
 
+#define GN3S_SAMPS_MS		(4000)			//!< GN3S samples per ms (real, one per byte)
+#define GN3S_UP				(64)			//!< GN3S resampling is by GN3S_UP/GN3S_DOWN, 4000 -> 2048 per ms
+#define GN3S_DOWN			(125)
+#define GN3S_TAPS			(24)			//!< Taps per phase of the GN3S polyphase filter
+#define GN3S_FIR_CUTOFF		(1.024e6)		//!< Filter cutoff (Hz), the output Nyquist
+#define USRP_TAPS			(24)			//!< Taps per phase of the USRP polyphase filter
+#define GN3S_NCO_BITS		(10)			//!< Phase resolution of the GN3S mixer table
+#define GN3S_MIX_AMP		(11)			//!< Mixer amplitude, the filtered output sits where the old unfiltered one did
+
+#define FILE_MAPS			(4)				//!< File windows that can be mapped at once, see Map_GPS_File
+
+#define IF_FILE_MAGIC		(0x46495347)	//!< "GSIF"
+#define IF_FILE_VERSION		(1)
+
+/*! \ingroup STRUCTS
+ *  @brief Header of a packed IF recording. Files without it are raw 16 bit CPX. The samples follow
+ *  the header, 8 bit as signed [I Q] bytes, 4 bit as one byte per sample with I in the low nibble,
+ *  2 bit as two samples per byte (see x86_unpack) */
+typedef struct IF_File_Header_S
+{
+
+	uint32	magic;				//!< IF_FILE_MAGIC
+	uint32	version;			//!< IF_FILE_VERSION
+	int32	bits;				//!< Bits per I or Q, 2, 4, 8, or 16
+	int32	fsample;			//!< Sample rate (Hz)
+	int32	samps_ms;			//!< Samples per ms
+	int32	pad[11];
+
+} IF_File_Header_S;
+
 /*! \ingroup CLASSES
  *
  */
@@ -63,13 +96,11 @@ class GPS_Source
 		time_t rawtime;
 		struct tm * timeinfo;
 
-		/* AGC Values */
-		int32 agc_scale;		//!< To do the AGC
-		int32 overflw;			//!< Overflow counter
-		int32 soverflw;			//!< Overflow counter
-		int32 soverflw2;			//!< Overflow counter
-		int32 agc_scale2;
-		int32 overflw2;			//!< Overflow counter
+		/* AGC Values, per antenna */
+		int32 agc_scale[MAX_ANTENNAS];		//!< To do the AGC
+		int32 overflw[MAX_ANTENNAS];		//!< Overflows in the last AGC_PERIOD
+		int32 soverflw[MAX_ANTENNAS];		//!< Overflow counter
+		uint32 agc_hist[MAX_ANTENNAS][AGC_HIST_BINS];	//!< Sample magnitudes of the last ms of the last AGC_PERIOD
 
 
 
@@ -80,14 +111,12 @@ class GPS_Source
 		CPX buff_out[10240]; 	//!< Output buffer @ 2.048 Msps
 		CPX *buff_out_p; 		//!< Pointer to a spot in buff_out
 		CPX dbuff[16384]; 		//!< Buffer for double buffering
-		MIX gn3s_mix[10240];	//!< Mix GN3S to the same IF frequency
-		int32 gdec[10240];		//!< Index array to filter & resample GN3S data to 2.048 Msps
-		CPX file_buff[SAMPS_MS]; 	//!< Base 1ms buffer for a file	
+		CPX gn3s_lut[4 << GN3S_NCO_BITS];	//!< Mixer output for each [phase, 2 bit sample]
+		Resampler *gn3s_rs;		//!< Filter & resample GN3S data to 2.048 Msps
+		Resampler *usrp_rs;		//!< Filter & resample (and de-interleave) USRP data to 2.048 Msps
+		int32 usrp_samps_ms;	//!< USRP samples per ms (per board)
 
-		double sin_table[1024];
-		double cos_table[1024];
 		unsigned int delta_phase;
-		unsigned int short_phase;
 		unsigned int phase;
 
 
@@ -101,15 +130,33 @@ class GPS_Source
 		/* SOURCE_SIGE_GN3S Handles */
 		gn3s *gn3s_a;
 		gn3s *gn3s_b;
+		unsigned int gn3s_overruns;	//!< Ring overruns already reported
+
+		/* File playback */
+		int32 file_fd[MAX_ANTENNAS];		//!< Input files
+		int32 file_ants;					//!< Number of input files
+		int32 file_win;						//!< Index of the current window
+		int32 file_cur;						//!< Mapping slot holding the current window
+		int32 file_slot_win[FILE_MAPS];		//!< Window held by each mapping slot, -1 if free
+		int64 file_retired[FILE_MAPS];		//!< file_played when each slot stopped being current
+		void *file_base[FILE_MAPS][MAX_ANTENNAS];	//!< Mapping of each file in each slot
+		size_t file_len[FILE_MAPS];			//!< Length of the mappings in each slot (bytes)
+		uint8 *file_map[MAX_ANTENNAS];		//!< First ms of the current window of each file
+		int32 file_bits;					//!< Bits per I or Q in the file(s)
+		int32 file_bytes_ms;				//!< Bytes per ms in the file(s)
+		int64 file_data;					//!< Offset of the samples (past any header)
+		int64 file_ms;						//!< Length of the (shortest) file in ms
+		int64 file_start;					//!< First ms to play
+		int64 file_end;						//!< One past the last ms to play
+		int64 file_pos;						//!< Next ms to play
+		int64 file_played;					//!< Packets played, for pacing
+		struct timeval file_t0;				//!< Wall clock at the start of playback
+
+		/* Pluggable sources */
+		Sample_Source *stream;				//!< Socket, pipe, or stdin
 
-		/* File handles */
-		FILE *fp_a;		//!<file for input 1
-		FILE *fp_b;		//!<file for input 2
-		FILE *out_file_a;	//!< output file 1
-		FILE *out_file_b;	//!<output file 2
 	
 
-		bool record_on;
 		int32 started;
 		
 
@@ -120,14 +167,18 @@ class GPS_Source
 		void Open_USRP_V2();		//!< Open the USRP Version 2
 		void Open_GN3S();			//!< Open the SparkFun GN3S Sampler
 		void Open_GPS_File();			//!< Open the file
+		void Open_Stream();				//!< Open a pluggable source
 		void Close_USRP_V1();		//!< Close the USRP Version 1
 		void Close_USRP_V2();		//!< Close the USRP Version 2
 		void Close_GN3S();			//!< Close the SparkFun GN3S Sampler
 		void Close_GPS_File();			//!< Close the file
+		void Close_Stream();			//!< Close a pluggable source
 		void Read_USRP_V1(ms_packet *_p);//!< Read from the USRP Version 1
 		void Read_USRP_V2(ms_packet *_p);//!< Read from the USRP Version 2
 		void Read_GN3S(ms_packet *_p);	//!< Read from the SparkFun GN3S Sampler
 		void Read_GPS_File(ms_packet *_p);	//!< Read from a file
+		void Read_Stream(ms_packet *_p);	//!< Read from a pluggable source
+		void Map_GPS_File(int32 _win);	//!< Map a window of the file(s)
 		void Resample_USRP_V1(CPX *_in, CPX *_out);
 		void Resample_GN3S(CPX *_in, CPX *_out);
 
@@ -136,8 +187,12 @@ class GPS_Source
 		GPS_Source(Options_S *_opt);	//!< Create the GPS source with the proper hardware type
 		~GPS_Source();					//!< Kill the object
 		void Read(ms_packet *_p);		//!< Read in a single ms of data
-		int32 getScale(){return(agc_scale);}
-		int32 getOvrflw(){return(overflw);}
+		int32 getScale(int32 _ant){return(agc_scale[_ant]);}
+		int32 getOvrflw(int32 _ant){return(overflw[_ant]);}
+		uint32 *getHist(int32 _ant){return(agc_hist[_ant]);}
+		uint32 getUSBBlocks();			//!< USB blocks received
+		uint32 getUSBOverruns();		//!< USB blocks lost to a full sample ring
+		uint32 getUSBErrors();			//!< Failed USB reads
 
 };
 
@@ -0,0 +1,147 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file loop_bank.cpp
+//
+// FILENAME: loop_bank.cpp
+//
+// DESCRIPTION: Implements member functions of the Loop_Bank class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "loop_bank.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Loop_Bank::Loop_Bank()
+{
+
+	memset(&blocks[0], 0x0, LOOP_BLOCKS*sizeof(Loop_Block_S));
+
+	if(gopt.verbose)
+		fprintf(stdout,"Creating Loop Bank\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Loop_Bank::~Loop_Bank()
+{
+
+	if(gopt.verbose)
+		fprintf(stdout,"Destructing Loop Bank\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Loop_Bank::Clear(int32 _chan)
+{
+
+	Loop_Block_S *b = &blocks[_chan >> 2];
+	int32 lane = _chan & 0x3;
+
+	b->ip[lane] = b->qp[lane] = 0;
+	b->pe[lane] = b->pl[lane] = 0;
+	b->pll[lane] = b->pull[lane] = b->load[lane] = 0;
+	b->kw[lane] = b->kx[lane] = b->kz[lane] = b->kh[lane] = 0;
+	b->w[lane] = b->x[lane] = b->z[lane] = 0;
+	b->code[lane] = 0;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Loop_Bank::Start(int32 _chan, float _doppler)
+{
+
+	Loop_Block_S *b = &blocks[_chan >> 2];
+	int32 lane = _chan & 0x3;
+
+	b->w[lane] = 0;
+	b->x[lane] = 2.0*_doppler;
+	b->z[lane] = _doppler;
+	b->code[lane] = _doppler*CODE_RATE*INVERSE_L1;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Bandwidth: 3rd order PLL coefficients, the FLL assist is not used so its terms are dropped.
+ * */
+void Loop_Bank::Bandwidth(int32 _chan, float _bw, int32 _len)
+{
+
+	Loop_Block_S *b = &blocks[_chan >> 2];
+	int32 lane = _chan & 0x3;
+	float w0p, t;
+
+	w0p = _bw/0.7845;
+	t = .001*(float)_len;
+
+	b->kw[lane] = t*w0p*w0p*w0p;
+	b->kx[lane] = t*1.10*w0p*w0p;
+	b->kz[lane] = 2.40*w0p;
+	b->kh[lane] = 0.5*t;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Loop_Bank::AddFrequency(int32 _chan, float _df)
+{
+
+	blocks[_chan >> 2].x[_chan & 0x3] += 2.0*_df;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Loop_Bank::Load(int32 _chan, int32 _I, int32 _Q, int32 _PE, int32 _PL, bool _pll, bool _pull)
+{
+
+	Loop_Block_S *b = &blocks[_chan >> 2];
+	int32 lane = _chan & 0x3;
+
+	b->ip[lane] = (float)_I;
+	b->qp[lane] = (float)_Q;
+	b->pe[lane] = (float)_PE;
+	b->pl[lane] = (float)_PL;
+	b->pll[lane] = _pll ? -1 : 0;
+	b->pull[lane] = _pull ? -1 : 0;
+	b->load[lane] = -1;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Loop_Bank::Update()
+{
+
+	sse_loops(&blocks[0], LOOP_BLOCKS);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file loop_bank.h
+//
+// FILENAME: loop_bank.h
+//
+// DESCRIPTION: Defines the Loop_Bank class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef LOOP_BANK_H_
+#define LOOP_BANK_H_
+
+#include "includes.h"
+
+/*! \ingroup CLASSES
+ *  @brief The PLL/DLL of every channel, kept in Loop_Block_S's so they can all be closed in one SSE
+ *  sweep. A channel that dumps Load()s its correlations, the correlator calls Update() once every
+ *  channel due this ms has dumped, then each channel picks up its NCOs. Lane n belongs to channel n,
+ *  and is only touched by that channel (under its lock) or by the correlator thread.
+ */
+class Loop_Bank
+{
+
+	private:
+
+		Loop_Block_S blocks[LOOP_BLOCKS];
+
+	public:
+
+		Loop_Bank();
+		~Loop_Bank();
+		void Clear(int32 _chan);										//!< Zero the channel's loops
+		void Start(int32 _chan, float _doppler);						//!< Seed the loops with the acquired Doppler
+		void Bandwidth(int32 _chan, float _bw, int32 _len);				//!< Set the PLL bandwidth and integration length (ms)
+		void AddFrequency(int32 _chan, float _df);						//!< Apply a frequency correction (Hz)
+		void Load(int32 _chan, int32 _I, int32 _Q, int32 _PE, int32 _PL, bool _pll, bool _pull);	//!< Queue a dump for the next Update()
+		void Update();													//!< Close the loops of every channel loaded
+		float getCarrier(int32 _chan){return(blocks[_chan >> 2].z[_chan & 0x3]);}		//!< Carrier NCO offset from the IF
+		float getCode(int32 _chan){return(blocks[_chan >> 2].code[_chan & 0x3]);}		//!< Code NCO offset from CODE_RATE
+		float getW(int32 _chan){return(blocks[_chan >> 2].w[_chan & 0x3]);}
+		float getX(int32 _chan){return(blocks[_chan >> 2].x[_chan & 0x3]);}
+		float getZ(int32 _chan){return(blocks[_chan >> 2].z[_chan & 0x3]);}
+};
+
+#endif /* LOOP_BANK_H_ */
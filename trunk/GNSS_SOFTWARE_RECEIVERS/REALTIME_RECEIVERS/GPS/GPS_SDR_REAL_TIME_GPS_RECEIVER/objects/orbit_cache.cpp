@@ -0,0 +1,249 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file orbit_cache.cpp
+//
+// FILENAME: orbit_cache.cpp
+//
+// DESCRIPTION: Implements member functions of the Orbit_Cache class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "orbit_cache.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Orbit_Cache::Orbit_Cache()
+{
+
+	Reset();
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Orbit_Cache::~Orbit_Cache()
+{
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Orbit_Cache::Reset()
+{
+
+	memset(&fits[0], 0x0, sizeof(Orbit_Fit_S)*MAX_SV);
+	refits = 0;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Exact: Position (x,y,z), velocity (vx,vy,vz), and the relativistic clock correction of the SV
+ * at _tk seconds from toe, straight from the ephemeris. The ORBIT_STATE enum indexes _state.
+ * */
+void Orbit_Cache::Exact(Ephemeris_M *_e, double _tk, double *_state)
+{
+
+	int32 iter;
+	double dtemp, M, E, cE, sE, dEdM, P, U, R, I, cU, sU, Xp, Yp, L, sI, cI, sL, cL, ecc, s2P, c2P;
+	double Edot, Pdot, Udot, Rdot, sUdot, cUdot, Xpdot, Ypdot, Idot, Ldot;
+	double Mdot, sqrt1mee;
+
+	//Mean anomaly, M (rads).
+	Mdot = _e->n0 + _e->deltan;
+	M = _e->m0 + Mdot * _tk;
+
+	// Obtain eccentric anomaly E by solving Kepler's equation.
+	ecc = _e->ecc;
+
+	sqrt1mee = sqrt (1.0 - ecc * ecc);
+	E = M;
+	for (iter = 0; iter < 20; iter++)
+	{
+		sE = sin(E); cE = cos(E);
+		dEdM = 1.0 / (1.0 - ecc * cE);
+		if (fabs (dtemp = (M - E + ecc * sE) * dEdM) < 1.0E-14)
+			break;
+		E += dtemp;
+	}
+
+	/* Compute the relativistic correction term (seconds). */
+	_state[ORBIT_REL] = (double)(-4.442807633E-10) * ecc * _e->sqrta * sE;
+
+	Edot = dEdM * Mdot;
+
+	/* Compute the argument of latitude, P. */
+	P = atan2 (sqrt1mee * sE, cE - ecc) + _e->argp;
+	Pdot = sqrt1mee * dEdM * Edot;
+
+	/* Generate harmonic correction terms for P and R. */
+	s2P = sin (2.0 * P);
+	c2P = cos (2.0 * P);
+
+	/* Compute the corrected argument of latitude, U. */
+	U = P + (_e->cus * s2P + _e->cuc * c2P);
+	sU = sin (U);
+	cU = cos (U);
+	Udot = Pdot * (1.0 + 2.0 * (_e->cus * c2P - _e->cuc * s2P));
+	sUdot = cU * Udot;
+	cUdot = -sU * Udot;
+
+	/* Compute the corrected radius, R. */
+	R = _e->a * (1.0 - ecc * cE) + (_e->crs * s2P +
+		_e->crc * c2P);
+	Rdot = _e->a * ecc * sE * Edot + 2.0 * Pdot
+		* (_e->crs * c2P - _e->crc * s2P);
+
+	/* Compute the corrected orbital inclination, I. */
+	I = _e->in0 + _e->idot * _tk
+	+ (_e->cis * s2P + _e->cic * c2P);
+	sI = sin (I);
+	cI = cos (I);
+	Idot = _e->idot + 2.0 * Pdot * (_e->cis * c2P - _e->cic * s2P);
+
+	/* Compute the satellite's position in its orbital plane, (Xp,Yp). */
+	Xp = R * cU;
+	Yp = R * sU;
+	Xpdot = Rdot * cU + R * cUdot;
+	Ypdot = Rdot * sU + R * sUdot;
+
+	/* Compute the longitude of the ascending node, L. */
+	L = _e->om0 + _tk * (_e->omd - (double)WGS84OE) - (double)WGS84OE * _e->toe;
+	Ldot = _e->omd - (double)WGS84OE;
+	sL = sin (L);
+	cL = cos (L);
+
+	/* Compute the satellite's position in space, (x,y,z). */
+	_state[ORBIT_X] = Xp * cL - Yp * cI * sL;
+	_state[ORBIT_Y] = Xp * sL + Yp * cI * cL;
+	_state[ORBIT_Z] = Yp * sI;
+
+	/* Satellite's velocity, (vx,vy,vz). */
+	_state[ORBIT_VX] = -Ldot * _state[ORBIT_Y]
+	+ Xpdot * cL
+	- Ypdot * cI * sL
+	+ Yp * sI * Idot * sL;
+
+	_state[ORBIT_VY] = Ldot * _state[ORBIT_X]
+	+ Xpdot * sL
+	+ Ypdot * cI * cL
+	- Yp * sI * Idot * cL;
+
+	_state[ORBIT_VZ] = +Yp * cI * Idot
+	+ Ypdot * sI;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Fit: Sample the exact orbit at the Chebyshev nodes of a new window and convert to coefficients.
+ * The window starts a little before _tk so small backward steps in the time of transmission (clock
+ * corrections) stay inside it.
+ * */
+void Orbit_Cache::Fit(Ephemeris_M *_e, double _tk, Orbit_Fit_S *_f)
+{
+
+	int32 lcv, lcv2, lcv3;
+	double mid, half, w;
+	double state[ORBIT_TERMS][ORBIT_STATES];
+
+	_f->t0 = _tk - ORBIT_SPAN/16.0;
+	_f->t1 = _f->t0 + ORBIT_SPAN;
+	mid = 0.5*(_f->t1 + _f->t0);
+	half = 0.5*(_f->t1 - _f->t0);
+
+	for(lcv = 0; lcv < ORBIT_TERMS; lcv++)
+		Exact(_e, mid + half*cos(PI*((double)lcv + 0.5)/(double)ORBIT_TERMS), &state[lcv][0]);
+
+	for(lcv = 0; lcv < ORBIT_TERMS; lcv++)
+	{
+		for(lcv3 = 0; lcv3 < ORBIT_STATES; lcv3++)
+			_f->coeff[lcv][lcv3] = 0;
+
+		for(lcv2 = 0; lcv2 < ORBIT_TERMS; lcv2++)
+		{
+			w = cos(PI*(double)lcv*((double)lcv2 + 0.5)/(double)ORBIT_TERMS);
+			for(lcv3 = 0; lcv3 < ORBIT_STATES; lcv3++)
+				_f->coeff[lcv][lcv3] += w*state[lcv2][lcv3];
+		}
+
+		for(lcv3 = 0; lcv3 < ORBIT_STATES; lcv3++)
+			_f->coeff[lcv][lcv3] *= 2.0/(double)ORBIT_TERMS;
+	}
+
+	_f->toe = _e->toe;
+	_f->iode = _e->iode;
+	_f->valid = true;
+
+	refits++;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Evaluate: Same output as Exact(), from the cached fit when possible.
+ * */
+void Orbit_Cache::Evaluate(Ephemeris_M *_e, double _tk, double *_state)
+{
+
+	int32 lcv, lcv2;
+	double u, b0, b1[ORBIT_STATES], b2[ORBIT_STATES];
+	Orbit_Fit_S *f;
+
+	if((int32)_e->sv >= MAX_SV)
+	{
+		Exact(_e, _tk, _state);
+		return;
+	}
+
+	f = &fits[_e->sv];
+
+	/* Refit on a new ephemeris or when leaving the window */
+	if((f->valid == false) || (f->iode != _e->iode) || (f->toe != _e->toe) || (_tk < f->t0) || (_tk > f->t1))
+		Fit(_e, _tk, f);
+
+	/* Clenshaw recurrence, all states at once */
+	u = (2.0*_tk - f->t0 - f->t1)/(f->t1 - f->t0);
+
+	for(lcv2 = 0; lcv2 < ORBIT_STATES; lcv2++)
+		b1[lcv2] = b2[lcv2] = 0;
+
+	for(lcv = ORBIT_TERMS-1; lcv > 0; lcv--)
+	{
+		for(lcv2 = 0; lcv2 < ORBIT_STATES; lcv2++)
+		{
+			b0 = 2.0*u*b1[lcv2] - b2[lcv2] + f->coeff[lcv][lcv2];
+			b2[lcv2] = b1[lcv2];
+			b1[lcv2] = b0;
+		}
+	}
+
+	for(lcv2 = 0; lcv2 < ORBIT_STATES; lcv2++)
+		_state[lcv2] = u*b1[lcv2] - b2[lcv2] + 0.5*f->coeff[0][lcv2];
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file orbit_cache.h
+//
+// FILENAME: orbit_cache.h
+//
+// DESCRIPTION: Defines the Orbit_Cache class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef ORBIT_CACHE_H_
+#define ORBIT_CACHE_H_
+
+#include "includes.h"
+
+enum ORBIT_STATE
+{
+	ORBIT_X,
+	ORBIT_Y,
+	ORBIT_Z,
+	ORBIT_VX,
+	ORBIT_VY,
+	ORBIT_VZ,
+	ORBIT_REL,
+	ORBIT_STATES
+};
+
+/*! \ingroup STRUCTS
+ *  @brief Chebyshev fit of one SV's orbit over [t0, t1], tk relative to toe */
+typedef struct Orbit_Fit_S
+{
+
+	double	coeff[ORBIT_TERMS][ORBIT_STATES];	//!< Chebyshev coefficients, term major
+	double	t0;									//!< Start of the fit (seconds from toe)
+	double	t1;									//!< End of the fit (seconds from toe)
+	double	toe;								//!< Ephemeris the fit was made from
+	uint32	iode;								//!< Ephemeris the fit was made from
+	uint32	valid;								//!< Is this fit usable
+
+} Orbit_Fit_S;
+
+/*! \ingroup CLASSES
+ *  @brief Caches the SV orbits as polynomials. Kepler's equation and the harmonic corrections are
+ *  only evaluated at the ORBIT_TERMS Chebyshev nodes of an ORBIT_SPAN second window, every epoch
+ *  inside the window is then a short Clenshaw recurrence. A new IODE/toe or leaving the window
+ *  triggers a refit.
+ */
+class Orbit_Cache
+{
+
+	private:
+
+		Orbit_Fit_S fits[MAX_SV];		//!< One fit per SV
+		uint32 refits;					//!< Number of fits made
+
+		void Fit(Ephemeris_M *_e, double _tk, Orbit_Fit_S *_f);		//!< Fit a window starting near _tk
+
+	public:
+
+		Orbit_Cache();
+		~Orbit_Cache();
+		void Reset();														//!< Drop all fits
+		void Exact(Ephemeris_M *_e, double _tk, double *_state);			//!< Full IS-GPS-200 orbit at _tk
+		void Evaluate(Ephemeris_M *_e, double _tk, double *_state);			//!< Cached orbit at _tk
+		uint32 getRefits(){return(refits);}									//!< Number of fits made
+};
+
+#endif /* ORBIT_CACHE_H_ */
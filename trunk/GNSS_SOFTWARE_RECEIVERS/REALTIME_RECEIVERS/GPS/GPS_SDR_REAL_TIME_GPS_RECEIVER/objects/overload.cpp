@@ -0,0 +1,224 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file overload.cpp
+//
+// FILENAME: overload.cpp
+//
+// DESCRIPTION: Implements member functions of the Overload class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "overload.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Overload::Overload()
+{
+
+	level = OVERLOAD_NORMAL;
+	cap = MAX_CHANNELS;
+	stress = calm = 0;
+	ms = busy = 0;
+	util = 0;
+	backlog = last_backlog = 0;
+	sheds = 0;
+
+	if(gopt.verbose)
+		fprintf(stdout,"Creating Overload\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Overload::~Overload()
+{
+
+	if(gopt.verbose)
+		fprintf(stdout,"Destructing Overload\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Overload::Update(int32 _us, int32 _backlog)
+{
+
+	busy += _us;
+	ms++;
+
+	if(ms >= OVERLOAD_PERIOD)
+	{
+		backlog = _backlog;
+		Evaluate();
+		last_backlog = backlog;
+		ms = busy = 0;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Evaluate: Overloaded if the correlator is taking too long per ms, or if its backlog is large and
+ * still not draining. Relaxed only if both are comfortably low. Anything in between holds the level.
+ * The backlog is the correlator's own, an acquisition snapshot pinning the FIFO does not count.
+ * */
+void Overload::Evaluate()
+{
+
+	int32 fill;
+	bool overloaded, relaxed;
+
+	util += (busy/ms - util)/OVERLOAD_SMOOTH;
+	fill = 100*backlog/pFIFO->getDepth();
+
+	overloaded = (util > OVERLOAD_UTIL_HI) || ((fill > OVERLOAD_FILL_HI) && (backlog >= last_backlog));
+	relaxed = (util < OVERLOAD_UTIL_LO) && (fill < OVERLOAD_FILL_LO);
+
+	if(overloaded)
+	{
+		calm = 0;
+		if(++stress >= OVERLOAD_HOLD_UP)
+		{
+			stress = 0;
+			Escalate();
+		}
+	}
+	else if(relaxed)
+	{
+		stress = 0;
+		if(++calm >= OVERLOAD_HOLD_DOWN)
+		{
+			calm = 0;
+			Relax();
+		}
+	}
+	else
+	{
+		stress = calm = 0;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Overload::Escalate()
+{
+
+	int32 lcv, active;
+
+	if(level == OVERLOAD_SHED)
+	{
+		Shed();
+		return;
+	}
+
+	level++;
+
+	/* Freeze the channel count, the next escalation starts dropping them */
+	if(level == OVERLOAD_SHED)
+	{
+		active = 0;
+		for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
+		{
+			pChannels[lcv]->Lock();
+			if(pChannels[lcv]->getState() != CHANNEL_EMPTY)
+				active++;
+			pChannels[lcv]->Unlock();
+		}
+
+		cap = active;
+	}
+
+	if(gopt.verbose)
+		fprintf(stdout,"Overload level %d, %d us/ms, backlog %d ms\n",level,util,backlog);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Overload::Relax()
+{
+
+	/* Let the channels back in one at a time before stepping down */
+	if((level == OVERLOAD_SHED) && (cap < MAX_CHANNELS))
+	{
+		cap++;
+		return;
+	}
+
+	if(level == OVERLOAD_NORMAL)
+		return;
+
+	level--;
+	cap = MAX_CHANNELS;
+
+	if(gopt.verbose)
+		fprintf(stdout,"Overload level %d, %d us/ms, backlog %d ms\n",level,util,backlog);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Overload::Shed()
+{
+
+	int32 lcv, active, lowest;
+	float cn0;
+
+	active = 0;
+	lowest = -1;
+	cn0 = 0;
+
+	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
+	{
+		pChannels[lcv]->Lock();
+		if(pChannels[lcv]->getState() != CHANNEL_EMPTY)
+		{
+			active++;
+			if((lowest == -1) || (pChannels[lcv]->getCN0() < cn0))
+			{
+				lowest = lcv;
+				cn0 = pChannels[lcv]->getCN0();
+			}
+		}
+		pChannels[lcv]->Unlock();
+	}
+
+	if(active <= OVERLOAD_MIN_CHANNELS)
+		return;
+
+	pChannels[lowest]->Lock();
+	pChannels[lowest]->Kill();
+	pChannels[lowest]->Unlock();
+
+	cap = active - 1;
+	sheds++;
+
+	if(gopt.verbose)
+		fprintf(stdout,"Overload shed channel %d (%.1f dB-Hz), %d channels left\n",lowest,cn0,cap);
+
+}
+/*----------------------------------------------------------------------------------------------*/
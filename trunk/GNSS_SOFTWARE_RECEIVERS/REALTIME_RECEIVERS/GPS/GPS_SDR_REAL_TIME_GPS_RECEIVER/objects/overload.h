@@ -0,0 +1,83 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file overload.h
+//
+// FILENAME: overload.h
+//
+// DESCRIPTION: Defines the Overload class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef OVERLOAD_H_
+#define OVERLOAD_H_
+
+#include "includes.h"
+#include "channel.h"
+#include "fifo.h"
+
+enum OVERLOAD_LEVEL
+{
+	OVERLOAD_NORMAL,		//!< Keeping up
+	OVERLOAD_PAUSE,			//!< Weak acquisitions paused
+	OVERLOAD_STRETCH,		//!< Acquisition yields for longer between cells
+	OVERLOAD_SHED			//!< Dropping the lowest C/N0 channels
+};
+
+/*! \ingroup CLASSES
+ *  @brief Sheds load when the correlator falls behind real time. The correlator reports how long each
+ *  1 ms packet took and how far behind the FIFO it is, every OVERLOAD_PERIOD ms the smoothed load is
+ *  checked against the high/low marks. Sustained overload steps up through the levels, first pausing
+ *  weak acquisitions, then stretching the acquisition's yields, then dropping the lowest C/N0 channels
+ *  one at a time. Sustained relief lets the channels back in one at a time, then steps back down.
+ */
+class Overload
+{
+
+	private:
+
+		int32 level;				//!< OVERLOAD_NORMAL .. OVERLOAD_SHED
+		int32 cap;					//!< Most channels SV_Select may have busy
+		int32 stress;				//!< Consecutive overloaded periods
+		int32 calm;					//!< Consecutive relaxed periods
+		int32 ms;					//!< Packets in the current period
+		int32 busy;					//!< Correlation time of the current period (us)
+		int32 util;					//!< Smoothed correlation time per packet (us)
+		int32 backlog;				//!< Correlator's lag behind the FIFO at the end of this period
+		int32 last_backlog;			//!< Correlator's lag behind the FIFO at the end of the previous period
+		uint32 sheds;				//!< Channels dropped
+
+		void Evaluate();			//!< Once per period, move between the levels
+		void Escalate();			//!< Step up one level, or shed another channel
+		void Relax();				//!< Restore a channel, or step down one level
+		void Shed();				//!< Drop the lowest C/N0 channel
+
+	public:
+
+		Overload();
+		~Overload();
+		void Update(int32 _us, int32 _backlog);		//!< Called by the correlator once per packet when running in real time
+		int32 getLevel(){return(level);}
+		int32 getCap(){return(cap);}
+		int32 getUtil(){return(util);}
+		uint32 getSheds(){return(sheds);}
+		int32 getStretch(){return((level >= OVERLOAD_STRETCH) ? OVERLOAD_YIELD : 1);}	//!< Scale the acquisition's sleeps by this
+};
+
+#endif /* OVERLOAD_H_ */
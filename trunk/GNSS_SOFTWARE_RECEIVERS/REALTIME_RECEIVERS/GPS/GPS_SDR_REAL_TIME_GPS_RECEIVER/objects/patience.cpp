@@ -82,6 +82,17 @@ void Patience::PetMe()
 
 	uint32 new_tic;
 
+	/* Off the sample clock the source is a file, a stalled FIFO is back pressure rather than a hung
+	 * device, so just keep time in samples */
+	if(!gopt.realtime)
+	{
+		while(((uint32)gclock < (last_tic + WATCHDOG_MS)) && grun)
+			usleep(10000);
+
+		last_tic = gclock;
+		return;
+	}
+
 	if(pFIFO != NULL)
 	{
 		new_tic = pFIFO->getExecTic();
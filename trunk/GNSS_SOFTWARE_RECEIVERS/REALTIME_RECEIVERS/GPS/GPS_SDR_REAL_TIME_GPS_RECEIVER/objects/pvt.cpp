@@ -508,10 +508,8 @@ void PVT::SV_Positions()
 {
 
 	int32 lcv;
-	int32 iter;
-	double dtemp, M, E, cE, sE, dEdM, P, U, R, I, cU, sU, Xp, Yp, L, sI, cI, sL, cL, ecc, s2P, c2P, toc;
-	double Edot, Pdot, Udot, Rdot, sUdot, cUdot, Xpdot, Ypdot, Idot, Ldot;
-	double Mdot, sqrt1mee;
+	double state[ORBIT_STATES];
+	double toc;
 	double tk_p_toe, toe;
 	double dtk;
 	double tk;
@@ -553,75 +551,20 @@ void PVT::SV_Positions()
 			else if (tk < (-HALF_OF_SECONDS_IN_WEEK))
 				tk += SECONDS_IN_WEEK;
 
-			//Mean anomaly, M (rads).
-			Mdot = e->n0 + e->deltan;
-			M = e->m0 + Mdot * tk;
-
-			// Obtain eccentric anomaly E by solving Kepler's equation.
-			ecc = e->ecc;
-
-			sqrt1mee = sqrt (1.0 - ecc * ecc);
-			E = M;
-			for (iter = 0; iter < 20; iter++)
-			{
-				sE = sin(E); cE = cos(E);
-				dEdM = 1.0 / (1.0 - ecc * cE);
-				if (fabs (dtemp = (M - E + ecc * sE) * dEdM) < 1.0E-14)
-					break;
-				E += dtemp;
-			}
+			/* Orbit from the cached fit, Kepler is only solved when refitting */
+			if(ORBIT_CACHE)
+				orbits.Evaluate(e, tk, &state[0]);
+			else
+				orbits.Exact(e, tk, &state[0]);
 
-			/* Compute the relativistic correction term (seconds). */
-			e->relativistic = (double)(-4.442807633E-10) * ecc * e->sqrta * sE;
-
-			Edot = dEdM * Mdot;
-
-			/* Compute the argument of latitude, P. */
-			P = atan2 (sqrt1mee * sE, cE - ecc) + e->argp;
-			Pdot = sqrt1mee * dEdM * Edot;
-
-			/* Generate harmonic correction terms for P and R. */
-			s2P = sin (2.0 * P);
-			c2P = cos (2.0 * P);
-
-			/* Compute the corrected argument of latitude, U. */
-			U = P + (e->cus * s2P + e->cuc * c2P);
-			sU = sin (U);
-			cU = cos (U);
-			Udot = Pdot * (1.0 + 2.0 * (e->cus * c2P - e->cuc * s2P));
-			sUdot = cU * Udot;
-			cUdot = -sU * Udot;
-
-			/* Compute the corrected radius, R. */
-			R = e->a * (1.0 - ecc * cE) + (e->crs * s2P +
-				e->crc * c2P);
-			Rdot = e->a * ecc * sE * Edot + 2.0 * Pdot
-				* (e->crs * c2P - e->crc * s2P);
-
-			/* Compute the corrected orbital inclination, I. */
-			I = e->in0 + e->idot * tk
-			+ (e->cis * s2P + e->cic * c2P);
-			sI = sin (I);
-			cI = cos (I);
-			Idot = e->idot + 2.0 * Pdot * (e->cis * c2P - e->cic * s2P);
-
-			/* Compute the satellite's position in its orbital plane, (Xp,Yp). */
-			Xp = R * cU;
-			Yp = R * sU;
-			Xpdot = Rdot * cU + R * cUdot;
-			Ypdot = Rdot * sU + R * sUdot;
-
-			/* Compute the longitude of the ascending node, L. */
-			L = e->om0 + tk * (e->omd - (double)WGS84OE) - (double)WGS84OE * e->toe;
-			Ldot = e->omd - (double)WGS84OE;
-			sL = sin (L);
-			cL = cos (L);
-
-			/* Compute the satellite's position in space, (x,y,z). */
-			s->x = Xp * cL - Yp * cI * sL;
-			s->y = Xp * sL + Yp * cI * cL;
-	        s->z = Yp * sI;
+			e->relativistic = state[ORBIT_REL];
 
+			s->x = state[ORBIT_X];
+			s->y = state[ORBIT_Y];
+			s->z = state[ORBIT_Z];
+			s->vx = state[ORBIT_VX];
+			s->vy = state[ORBIT_VY];
+			s->vz = state[ORBIT_VZ];
 
 	        /* Compute SV clock correction */
 			s->time = tk;
@@ -638,20 +581,6 @@ void PVT::SV_Positions()
 			s->frequency_bias = e->af1 + (e->af2 *(tk_p_toe - toc)*2.0);
 
 
-			/* Satellite's velocity, (vx,vy,vz). */
-			s->vx = -Ldot * (s->y)
-			+ Xpdot * cL
-			- Ypdot * cI * sL
-			+ Yp * sI * Idot * sL;
-
-			s->vy = Ldot * (s->x)
-			+ Xpdot * sL
-			+ Ypdot * cI * cL
-			- Yp * sI * Idot * cL;
-
-			s->vz = +Yp * cI * Idot
-			+ Ypdot * sI;
-
 		} //end if good channel
 	}	//end lcv
 
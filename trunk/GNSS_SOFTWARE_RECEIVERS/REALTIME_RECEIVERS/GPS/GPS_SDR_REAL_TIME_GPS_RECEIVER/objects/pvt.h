@@ -31,6 +31,7 @@
 #include "includes.h"
 #include "ephemeris.h"
 #include "channel.h"
+#include "orbit_cache.h"
 
 enum PVT_CLOCK_STATE
 {
@@ -69,6 +70,7 @@ class PVT : public Threaded_Object
 		int32 master_sv[MAX_CHANNELS];							//!< Channel->SV map
 		int32 sv_codes[MAX_CHANNELS];							//!< Error codes
 		int32 doppler_suspect[MAX_CHANNELS][MAX_CHANNELS];		//!< For the cross-corr check
+		Orbit_Cache orbits;										//!< Polynomial fits of the SV orbits
 
 		/* Position and clock solutions */
 		SPS_M master_nav;										//!< Master nav sltn
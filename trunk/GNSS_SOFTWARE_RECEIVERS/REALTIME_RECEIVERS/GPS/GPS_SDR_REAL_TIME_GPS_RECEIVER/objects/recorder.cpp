@@ -0,0 +1,326 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file recorder.cpp
+//
+// FILENAME: recorder.cpp
+//
+// DESCRIPTION: Implements member functions of the Recorder class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "recorder.h"
+
+/*----------------------------------------------------------------------------------------------*/
+void *Recorder_Thread(void *_arg)
+{
+
+	Recorder *aRecorder = pRecorder;
+
+	while(grun)
+	{
+		aRecorder->Import();
+		aRecorder->Export();
+		aRecorder->IncExecTic();
+	}
+
+	pthread_exit(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Recorder::Start()
+{
+
+	Start_Thread(Recorder_Thread, NULL);
+
+	if(gopt.verbose)
+		fprintf(stdout,"Recorder thread started\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Recorder::Recorder():Threaded_Object("RECTASK")
+{
+
+	int32 lcv, flags;
+	const char *name;
+	IF_File_Header_S header;
+	uint8 *src[MAX_ANTENNAS];
+
+	ants = gopt.mode ? 2 : 1;
+	bits = gopt.record_bits;
+	bytes_ms = SAMPS_MS*2*bits/8;
+
+	/* The AGC leaves AGC_BITS of signal, packing drops the bottom bits so the top of the range
+	 * survives (2 bit keeps one more so +-3 still means something) */
+	shift = AGC_BITS - ((bits == 2) ? 3 : bits);
+	if((bits == 16) || (shift < 0))
+		shift = 0;
+
+	fill = 0;
+	valid = false;
+	ms_written = write_drops = latency = latency_max = 0;
+
+	for(lcv = 0; lcv < ants; lcv++)
+	{
+		name = (lcv == 0) ? "./data.dba" : "./data.dbb";
+
+		flags = O_WRONLY | O_CREAT | O_TRUNC | O_LARGEFILE;
+		fd[lcv] = open(name, flags | (RECORD_DIRECT ? O_DIRECT : 0), 0644);
+
+		/* Not every filesystem takes O_DIRECT */
+		if((fd[lcv] == -1) && RECORD_DIRECT)
+			fd[lcv] = open(name, flags, 0644);
+
+		if(fd[lcv] == -1)
+			fprintf(stderr,"Could not open %s, not recording it\n",name);
+		else
+			fprintf(stdout,"%s opened\n",name);
+
+		/* Reserve the space up front so the filesystem is not allocating under the writes */
+		if((fd[lcv] != -1) && (RECORD_PREALLOC_MS > 0))
+			fallocate64(fd[lcv], FALLOC_FL_KEEP_SIZE, 0, (int64)RECORD_PREALLOC_MS*bytes_ms);
+
+		if(posix_memalign((void **)&buff[lcv], RECORD_ALIGN, RECORD_BUFF_SIZE) != 0)
+		{
+			fprintf(stderr,"Could not allocate the record buffer, aborting.\n");
+			exit(1);
+		}
+
+		src[lcv] = (uint8 *)&header;
+	}
+	fflush(stdout);
+
+	/* Packed recordings carry a header, 16 bit stays headerless for the old tools */
+	if(bits != 16)
+	{
+		memset(&header, 0x0, sizeof(IF_File_Header_S));
+		header.magic	= IF_FILE_MAGIC;
+		header.version	= IF_FILE_VERSION;
+		header.bits		= bits;
+		header.fsample	= SAMPLE_FREQUENCY;
+		header.samps_ms	= SAMPS_MS;
+
+		Append(src, sizeof(IF_File_Header_S));
+	}
+
+	/* Lossy, the sampler must never wait on the disk */
+	reader = pFIFO->Register(pFIFO->getDepth()/2, false);
+
+	if(gopt.verbose)
+		fprintf(stdout,"Creating Recorder\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Recorder::~Recorder()
+{
+
+	int32 lcv;
+	int64 len;
+
+	if(reader != -1)
+		pFIFO->Unregister(reader);
+
+	/* The tail of the recording is not a whole number of blocks, finish it without O_DIRECT */
+	for(lcv = 0; lcv < ants; lcv++)
+		if(fd[lcv] != -1)
+			fcntl(fd[lcv], F_SETFL, fcntl(fd[lcv], F_GETFL) & ~O_DIRECT);
+
+	Flush();
+
+	for(lcv = 0; lcv < ants; lcv++)
+	{
+		if(fd[lcv] != -1)
+		{
+			/* Give back whatever was preallocated but not used */
+			len = lseek64(fd[lcv], 0, SEEK_CUR);
+			ftruncate64(fd[lcv], len);
+			close(fd[lcv]);
+		}
+
+		free(buff[lcv]);
+	}
+
+	if(gopt.verbose)
+		fprintf(stdout,"Destructing Recorder, %u ms recorded, %u ms dropped, longest write %u us\n",
+			ms_written, getDrops(), latency_max);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Recorder::Import()
+{
+
+	ms_packet *packet;
+	int32 lcv;
+
+	valid = false;
+
+	if(reader == -1)
+	{
+		usleep(100000);
+		return;
+	}
+
+	packet = pFIFO->Dequeue(reader);
+	if(packet == NULL)
+		return;
+
+	for(lcv = 0; lcv < ants; lcv++)
+	{
+		if(bits == 16)
+			memcpy(scratch[lcv], packet->payload[lcv], SAMPS_MS*sizeof(CPX));
+		else
+			x86_pack(packet->payload[lcv], scratch[lcv], SAMPS_MS, bits, shift);
+	}
+
+	/* Only keep it if the sampler did not lap us while packing */
+	valid = pFIFO->Retire(reader);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Recorder::Export()
+{
+
+	int32 lcv;
+	uint8 *src[MAX_ANTENNAS];
+
+	if(!valid)
+		return;
+
+	for(lcv = 0; lcv < ants; lcv++)
+		src[lcv] = scratch[lcv];
+
+	Append(src, bytes_ms);
+	ms_written++;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 Recorder::getDrops()
+{
+
+	if(reader == -1)
+		return(write_drops);
+
+	return(pFIFO->getOverruns(reader) + write_drops);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Recorder::Append(uint8 *_src[], int32 _bytes)
+{
+
+	int32 lcv, done, n;
+
+	done = 0;
+	while(done < _bytes)
+	{
+		n = RECORD_BUFF_SIZE - fill;
+		if(n > _bytes - done)
+			n = _bytes - done;
+
+		for(lcv = 0; lcv < ants; lcv++)
+			memcpy(&buff[lcv][fill], &_src[lcv][done], n);
+
+		fill += n;
+		done += n;
+
+		if(fill == RECORD_BUFF_SIZE)
+			Flush();
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Flush: Write out the buffers, timing each write. The thread is not cancelled part way through so
+ * the destructor never writes a buffer twice.
+ * */
+void Recorder::Flush()
+{
+
+	int32 lcv, state, done, n;
+	struct timeval t0, t1;
+
+	if(fill == 0)
+		return;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+
+	for(lcv = 0; lcv < ants; lcv++)
+	{
+		if(fd[lcv] == -1)
+			continue;
+
+		gettimeofday(&t0, NULL);
+
+		done = 0;
+		while(done < fill)
+		{
+			n = write(fd[lcv], &buff[lcv][done], fill - done);
+			if(n <= 0)
+			{
+				if((n == -1) && (errno == EINTR))
+					continue;
+				break;
+			}
+			done += n;
+		}
+
+		gettimeofday(&t1, NULL);
+
+		latency = (t1.tv_sec - t0.tv_sec)*1000000 + (t1.tv_usec - t0.tv_usec);
+		if(latency > latency_max)
+			latency_max = latency;
+
+		if(done < fill)
+		{
+			fprintf(stderr,"Record write failed (%s), closing the file\n",strerror(errno));
+			write_drops += (fill - done)/bytes_ms;
+			close(fd[lcv]);
+			fd[lcv] = -1;
+		}
+	}
+
+	fill = 0;
+
+	pthread_setcancelstate(state, NULL);
+
+}
+/*----------------------------------------------------------------------------------------------*/
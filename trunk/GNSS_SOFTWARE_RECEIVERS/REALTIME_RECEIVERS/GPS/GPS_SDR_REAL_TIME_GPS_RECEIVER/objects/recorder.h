@@ -0,0 +1,77 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file recorder.h
+//
+// FILENAME: recorder.h
+//
+// DESCRIPTION: Defines the Recorder class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include "includes.h"
+#include "fifo.h"
+
+/*! \ingroup CLASSES
+ *  @brief Records the IF data for the -r option. Runs as a lossy reader of the FIFO so a slow disk
+ *  can never hold up the sampler, the data is packed to opt.record_bits and collected into large
+ *  page aligned buffers that are written (O_DIRECT if RECORD_DIRECT) once full.
+ */
+class Recorder : public Threaded_Object
+{
+
+	private:
+
+		int32 reader;					//!< FIFO cursor
+		int32 ants;						//!< Number of antennas (files)
+		int32 bits;						//!< Bits per I or Q
+		int32 shift;					//!< Shift applied before packing
+		int32 bytes_ms;					//!< Bytes per ms per antenna
+		int32 fd[MAX_ANTENNAS];			//!< Output files
+		uint8 *buff[MAX_ANTENNAS];		//!< Aligned write buffers, RECORD_BUFF_SIZE bytes each
+		int32 fill;						//!< Bytes in each write buffer
+		uint8 scratch[MAX_ANTENNAS][SAMPS_MS*sizeof(CPX)];	//!< Last ms, packed
+		bool valid;						//!< Last ms survived the trip out of the FIFO
+
+		uint32 ms_written;				//!< Ms recorded
+		uint32 write_drops;				//!< Ms lost to failed writes
+		uint32 latency;					//!< Time of the last write (us)
+		uint32 latency_max;				//!< Longest write (us)
+
+		void Append(uint8 *_src[], int32 _bytes);	//!< Add the same number of bytes to each buffer
+		void Flush();								//!< Write out the buffers
+
+	public:
+
+		Recorder();
+		~Recorder();
+		void Start();						//!< Start the thread
+		void Import();						//!< Get the next ms from the FIFO
+		void Export();						//!< Buffer it, writing to disk as needed
+
+		uint32 getWritten(){return(ms_written);}
+		uint32 getDrops();					//!< Ms lost to FIFO overruns or the disk
+		uint32 getLatency(){return(latency);}
+		uint32 getLatencyMax(){return(latency_max);}
+};
+
+#endif /* RECORDER_H_ */
@@ -0,0 +1,175 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file resampler.cpp
+//
+// FILENAME: resampler.cpp
+//
+// DESCRIPTION: Implements member functions of the Resampler class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "resampler.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Resampler::Resampler(int32 _up, int32 _down, int32 _taps, int32 _chans, int32 _max_in, double _cutoff)
+{
+
+	up = _up;
+	down = _down;
+	taps = _taps;
+	chans = _chans;
+	max_in = _max_in;
+
+	fir = new MIX[up*chans*taps];
+
+	/* One spare sample, the last channel's window runs one zero tap past the block */
+	buff = new CPX[chans*(taps - 1 + max_in) + chans];
+
+	Design(_cutoff);
+	Reset();
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Resampler::~Resampler()
+{
+
+	delete [] fir;
+	delete [] buff;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Resampler::Reset()
+{
+
+	t = 0;
+	memset(buff, 0x0, (chans*(taps - 1 + max_in) + chans)*sizeof(CPX));
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Design: The prototype runs at up times the input rate. Each phase is quantized to RESAMPLER_BITS
+ * with any rounding error put on its biggest tap. Real taps are stored as MIX {h, 0, 0, h} so sse_cacc
+ * filters I and Q at once, and are reversed so it runs forward through the input.
+ * */
+void Resampler::Design(double _cutoff)
+{
+
+	int32 lcv, tap, len, sum, peak;
+	double x, fc, hsum;
+	double *h;
+	int16 *q;
+	MIX *p;
+
+	len = up*taps;
+	fc = _cutoff/(double)up;
+
+	h = new double[len];
+	q = new int16[taps];
+
+	for(lcv = 0; lcv < len; lcv++)
+	{
+		x = (double)lcv - (double)(len - 1)/2.0;
+		h[lcv] = (x == 0) ? 2.0*fc : sin(2*M_PI*fc*x)/(M_PI*x);
+		h[lcv] *= 0.54 - 0.46*cos(2*M_PI*(double)lcv/(double)(len - 1));
+	}
+
+	memset(fir, 0x0, up*chans*taps*sizeof(MIX));
+
+	for(lcv = 0; lcv < up; lcv++)
+	{
+		hsum = 0;
+		for(tap = 0; tap < taps; tap++)
+			hsum += h[tap*up + lcv];
+
+		sum = 0; peak = 0;
+		for(tap = 0; tap < taps; tap++)
+		{
+			q[tap] = (int16)floor((double)(1 << RESAMPLER_BITS)*h[tap*up + lcv]/hsum + 0.5);
+			sum += q[tap];
+			if(abs(q[tap]) > abs(q[peak]))
+				peak = tap;
+		}
+		q[peak] += (1 << RESAMPLER_BITS) - sum;
+
+		for(tap = 0; tap < taps; tap++)
+		{
+			p = &fir[(lcv*taps + taps - 1 - tap)*chans];
+			p->i = q[tap];
+			p->ni = q[tap];
+		}
+	}
+
+	delete [] h;
+	delete [] q;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Run: _in holds _cnt samples of each of the chans channels, interleaved. Output n of the block is
+ * the phase (t % up) filter over the taps inputs ending at sample t/up.
+ * */
+int32 Resampler::Run(CPX *_in, int32 _cnt, CPX *_out[])
+{
+
+	int32 lcv, k, m, iacc, qacc;
+	MIX *phase;
+
+	if(_cnt > max_in)
+		_cnt = max_in;
+
+	memcpy(&buff[chans*(taps - 1)], _in, chans*_cnt*sizeof(CPX));
+
+	k = 0;
+	while((m = t/up) < _cnt)
+	{
+		phase = &fir[(t % up)*chans*taps];
+
+		for(lcv = 0; lcv < chans; lcv++)
+		{
+			sse_cacc(&buff[chans*m + lcv], phase, chans*taps, &iacc, &qacc);
+
+			_out[lcv][k].i = (iacc + (1 << (RESAMPLER_BITS - 1))) >> RESAMPLER_BITS;
+			_out[lcv][k].q = (qacc + (1 << (RESAMPLER_BITS - 1))) >> RESAMPLER_BITS;
+		}
+
+		k++;
+		t += down;
+	}
+
+	/* Next block, keep the tail as history */
+	t -= up*_cnt;
+	memmove(&buff[0], &buff[chans*_cnt], chans*(taps - 1)*sizeof(CPX));
+
+	return(k);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,66 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file resampler.h
+//
+// FILENAME: resampler.h
+//
+// DESCRIPTION: Defines the Resampler class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+#include "includes.h"
+
+#define RESAMPLER_BITS		(14)	//!< Fixed point scaling of the filter taps
+
+/*! \ingroup CLASSES
+ *  @brief Fixed point polyphase resampler by any rational _up/_down. The prototype is a Hamming
+ *  windowed sinc of _up*_taps taps, split into _up phases of _taps, each normalized to unity gain.
+ *  The input may hold _chans interleaved channels, they are separated and filtered in the same pass
+ *  (the taps are zero stuffed so each sse_cacc only picks up its own channel). Filter history and
+ *  the fractional position carry across calls.
+ */
+class Resampler
+{
+
+	private:
+
+		int32 up;				//!< Interpolation factor
+		int32 down;				//!< Decimation factor
+		int32 taps;				//!< Taps per phase
+		int32 chans;			//!< Interleaved channels
+		int32 max_in;			//!< Most input samples (per channel) in one call
+		int32 t;				//!< Position of the next output, in 1/up input samples from the start of the block
+		MIX *fir;				//!< [up][chans*taps] taps, reversed and zero stuffed for sse_cacc
+		CPX *buff;				//!< Filter history followed by the input block
+
+		void Design(double _cutoff);	//!< Compute the taps
+
+	public:
+
+		Resampler(int32 _up, int32 _down, int32 _taps, int32 _chans, int32 _max_in, double _cutoff);	//!< _cutoff is relative to the input rate
+		~Resampler();
+		int32 Run(CPX *_in, int32 _cnt, CPX *_out[]);	//!< Resample _cnt samples per channel, returns outputs per channel
+		void Reset();									//!< Clear the history
+};
+
+#endif /* RESAMPLER_H_ */
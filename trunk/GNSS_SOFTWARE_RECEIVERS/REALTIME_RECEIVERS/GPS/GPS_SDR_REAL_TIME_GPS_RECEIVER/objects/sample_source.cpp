@@ -0,0 +1,61 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file sample_source.cpp
+//
+// FILENAME: sample_source.cpp
+//
+// DESCRIPTION: Implements the Sample_Source factory.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "sample_source.h"
+#include "stream_source.h"
+#include "sim_source.h"
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Make: The spec is tcp:<host>:<port> (connect), udp:[<host>:]<port> (bind), sim:<satellites> or
+ * sim:<scenario file> (synthetic IF), - for stdin, or the path of a named pipe. Returns NULL if the source
+ * could not be opened.
+ * */
+Sample_Source *Sample_Source::Make(const char *_spec, int32 _ants)
+{
+
+	Sample_Source *source;
+
+	if(strncmp(_spec, "tcp:", 4) == 0)
+		source = new Stream_Source(STREAM_TCP, &_spec[4], _ants);
+	else if(strncmp(_spec, "udp:", 4) == 0)
+		source = new Stream_Source(STREAM_UDP, &_spec[4], _ants);
+	else if(strncmp(_spec, "sim:", 4) == 0)
+		source = new Sim_Source(&_spec[4], _ants);
+	else
+		source = new Stream_Source(STREAM_PIPE, _spec, _ants);
+
+	if(!source->isOpen())
+	{
+		delete source;
+		return(NULL);
+	}
+
+	return(source);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file sample_source.h
+//
+// FILENAME: sample_source.h
+//
+// DESCRIPTION: Defines the Sample_Source interface.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef SAMPLE_SOURCE_H_
+#define SAMPLE_SOURCE_H_
+
+#include "includes.h"
+
+/*! \ingroup CLASSES
+ *  @brief A pluggable supply of IF samples. Read() fills one FIFO slot with the next ms for every
+ *  antenna, either writing into _p->data or pointing _p->payload at samples it keeps valid for at least
+ *  FIFO depth more reads. New sources only need a subclass and a line in Make().
+ */
+class Sample_Source
+{
+
+	public:
+
+		virtual ~Sample_Source(){}
+		virtual bool isOpen() = 0;					//!< Did the source come up
+		virtual bool Read(ms_packet *_p) = 0;		//!< Fill the slot, false once the source has ended
+		virtual const char *getName() = 0;			//!< Describe the source
+
+		static Sample_Source *Make(const char *_spec, int32 _ants);	//!< Create the source named by _spec
+};
+
+#endif /* SAMPLE_SOURCE_H_ */
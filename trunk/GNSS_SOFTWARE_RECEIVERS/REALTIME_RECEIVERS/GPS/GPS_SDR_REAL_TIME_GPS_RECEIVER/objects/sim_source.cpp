@@ -0,0 +1,315 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file sim_source.cpp
+//
+// FILENAME: sim_source.cpp
+//
+// DESCRIPTION: Implements member functions of the Sim_Source class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "sim_source.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Sim_Source::Sim_Source(const char *_spec, int32 _ants)
+{
+
+	int32 lcv;
+	double u1, u2, r;
+
+	ants = _ants;
+	nsv = 0;
+	played = 0;
+	rng = SIM_SEED;
+	svs = new Sim_SV_S[MAX_SV];
+	noise = NULL;
+
+	snprintf(name, 1024, "sim:%s", _spec);
+
+	if(!Scenario(_spec))
+	{
+		fprintf(stderr,"Could not make a scenario from %s\n",name);
+		nsv = 0;
+		return;
+	}
+
+	/* Box-Muller, at the internal scale */
+	noise = new CPX[1 << SIM_NOISE_BITS];
+	for(lcv = 0; lcv < (1 << SIM_NOISE_BITS); lcv++)
+	{
+		u1 = ((double)Random() + 1.0)/4294967297.0;
+		u2 = (double)Random()/4294967296.0;
+		r = sqrt(-2.0*log(u1))*(double)(SIM_NOISE << SIM_SHIFT);
+		noise[lcv].i = (int16)floor(r*cos(TWO_PI*u2) + 0.5);
+		noise[lcv].q = (int16)floor(r*sin(TWO_PI*u2) + 0.5);
+	}
+
+	for(lcv = 0; lcv < nsv; lcv++)
+		Setup(&svs[lcv]);
+
+	if(gopt.verbose)
+	{
+		fprintf(stdout,"Simulating %d satellites\n",nsv);
+		fprintf(stdout,"PRN    C/N0   Doppler      Rate     Delay\n");
+		for(lcv = 0; lcv < nsv; lcv++)
+			fprintf(stdout,"%3d %7.2f %9.2f %9.3f %9.3f\n",svs[lcv].sv+1,svs[lcv].cn0,svs[lcv].doppler,
+				svs[lcv].doppler_rate,svs[lcv].code_delay);
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Sim_Source::~Sim_Source()
+{
+
+	delete [] svs;
+
+	if(noise != NULL)
+		delete [] noise;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 Sim_Source::Random()
+{
+
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+
+	return(rng);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Scenario: A count (with an optional :<C/N0>) simulates PRNs 1 to count with repeatable random
+ * Doppler, Doppler rate, and code delay. Otherwise the spec is a file with a line per satellite,
+ * "<prn> <C/N0> <doppler> <doppler rate> <code delay in chips>", # starts a comment.
+ * */
+bool Sim_Source::Scenario(const char *_spec)
+{
+
+	FILE *fp;
+	char line[1024];
+	char *end;
+	int32 lcv, count, prn;
+	double cn0;
+	Sim_SV_S *s;
+
+	count = (int32)strtol(_spec, &end, 10);
+	if((end != _spec) && ((*end == '\0') || (*end == ':')))
+	{
+		cn0 = (*end == ':') ? strtod(&end[1], NULL) : SIM_CN0;
+		if((count < 1) || (count > MAX_SV))
+			return(false);
+
+		for(lcv = 0; lcv < count; lcv++)
+		{
+			s = &svs[lcv];
+			s->sv = lcv;
+			s->cn0 = cn0;
+			s->doppler = SIM_MAX_DOPPLER*(2.0*(double)Random()/4294967296.0 - 1.0);
+			s->doppler_rate = SIM_MAX_DOPPLER_RATE*(2.0*(double)Random()/4294967296.0 - 1.0);
+			s->code_delay = (double)CODE_CHIPS*(double)Random()/4294967296.0;
+		}
+
+		nsv = count;
+		return(true);
+	}
+
+	fp = fopen(_spec, "r");
+	if(fp == NULL)
+		return(false);
+
+	while((nsv < MAX_SV) && (fgets(line, 1024, fp) != NULL))
+	{
+		if((end = strchr(line, '#')) != NULL)
+			*end = '\0';
+
+		s = &svs[nsv];
+		if(sscanf(line, "%d %lf %lf %lf %lf", &prn, &s->cn0, &s->doppler, &s->doppler_rate, &s->code_delay) != 5)
+			continue;
+
+		if((prn < 1) || (prn > MAX_SV))
+			continue;
+
+		s->sv = prn - 1;
+		nsv++;
+	}
+
+	fclose(fp);
+
+	return(nsv > 0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Setup: The amplitude follows from C/N0 against the complex noise power 2*sigma^2 spread over
+ * SAMPLE_FREQUENCY. A delay of d chips means the first code epoch arrives d chips into the data.
+ * */
+void Sim_Source::Setup(Sim_SV_S *_s)
+{
+
+	int32 lcv;
+	double amp, theta, delay;
+	CPX chips[CODE_CHIPS];
+
+	code_gen(&chips[0], _s->sv);
+	for(lcv = 0; lcv < CODE_CHIPS; lcv++)
+		_s->code[lcv] = chips[lcv].i;
+
+	amp = (double)(SIM_NOISE << SIM_SHIFT)*sqrt(2.0*pow(10.0, (_s->cn0 - 10.0*log10((double)SAMPLE_FREQUENCY))/10.0));
+	for(lcv = 0; lcv < (1 << SIM_LUT_BITS); lcv++)
+	{
+		theta = TWO_PI*(double)lcv/(double)(1 << SIM_LUT_BITS);
+		_s->lut[lcv].i = (int16)floor(amp*cos(theta) + 0.5);
+		_s->lut[lcv].q = (int16)floor(amp*sin(theta) + 0.5);
+	}
+
+	delay = fmod((double)CODE_CHIPS - fmod(_s->code_delay, (double)CODE_CHIPS), (double)CODE_CHIPS);
+	_s->code_phase = (uint64)(delay*4294967296.0);
+	_s->carr_phase = 0;
+	_s->epochs = 0;
+	_s->data = SIM_SEED ^ ((uint32)(_s->sv + 1)*2654435761u);
+	_s->bit = 0;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Generate: Step the code and carrier NCOs through one ms into the replica. The data bit flips on
+ * every 20th code epoch, then the Doppler moves on by its rate.
+ * */
+void Sim_Source::Generate(Sim_SV_S *_s)
+{
+
+	int32 lcv;
+	uint32 carr_step;
+	uint64 code_step, wrap;
+	CPX *c;
+
+	carr_step = (uint32)(int64)floor((IF_FREQUENCY + _s->doppler)*4294967296.0/SAMPLE_FREQUENCY + 0.5);
+	code_step = (uint64)floor(CODE_RATE*(1.0 + _s->doppler/L1)*4294967296.0/SAMPLE_FREQUENCY + 0.5);
+	wrap = (uint64)CODE_CHIPS << 32;
+
+	for(lcv = 0; lcv < SAMPS_MS; lcv++)
+	{
+		c = &_s->lut[_s->carr_phase >> (32 - SIM_LUT_BITS)];
+
+		if(_s->code[_s->code_phase >> 32] ^ _s->bit)
+		{
+			replica[lcv].i = c->i;
+			replica[lcv].q = c->q;
+		}
+		else
+		{
+			replica[lcv].i = -c->i;
+			replica[lcv].q = -c->q;
+		}
+
+		_s->carr_phase += carr_step;
+		_s->code_phase += code_step;
+
+		if(_s->code_phase >= wrap)
+		{
+			_s->code_phase -= wrap;
+
+			if(++_s->epochs == 20)
+			{
+				_s->epochs = 0;
+				_s->data ^= _s->data << 13;
+				_s->data ^= _s->data >> 17;
+				_s->data ^= _s->data << 5;
+				_s->bit = _s->data & 0x1;
+			}
+		}
+	}
+
+	_s->doppler += _s->doppler_rate*.001;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Read: Draw every sample's noise from the pool (two indices per Random()), add every satellite, then
+ * bring the sum down to the output scale with a rounded shift. Paced like file playback by opt.file_pace.
+ * */
+bool Sim_Source::Read(ms_packet *_p)
+{
+
+	int32 lcv;
+	uint32 r;
+	CPX *p;
+	struct timeval now;
+	double elapsed, target;
+
+	p = &_p->data[0][0];
+	for(lcv = 0; lcv < SAMPS_MS; lcv += 2)
+	{
+		r = Random();
+		p[lcv] = noise[(r & 0xFFFF) >> (16 - SIM_NOISE_BITS)];
+		p[lcv+1] = noise[r >> (32 - SIM_NOISE_BITS)];
+	}
+
+	for(lcv = 0; lcv < nsv; lcv++)
+	{
+		Generate(&svs[lcv]);
+		sse_add((int16 *)&_p->data[0][0], (int16 *)&replica[0], 2*SAMPS_MS);
+	}
+
+	sse_agc(&_p->data[0][0], SAMPS_MS, AGC_BITS, SIM_SHIFT);
+
+	for(lcv = 1; lcv < ants; lcv++)
+		memcpy(&_p->data[lcv][0], &_p->data[0][0], SAMPS_MS*sizeof(CPX));
+
+	played++;
+
+	/* Hold back to the requested rate */
+	if(gopt.file_pace > 0)
+	{
+		if(played == 1)
+			gettimeofday(&t0, NULL);
+
+		gettimeofday(&now, NULL);
+		elapsed = (double)(now.tv_sec - t0.tv_sec)*1e6 + (double)(now.tv_usec - t0.tv_usec);
+		target = (double)played*1000.0/gopt.file_pace;
+
+		if(target > elapsed)
+			usleep((useconds_t)(target - elapsed));
+	}
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
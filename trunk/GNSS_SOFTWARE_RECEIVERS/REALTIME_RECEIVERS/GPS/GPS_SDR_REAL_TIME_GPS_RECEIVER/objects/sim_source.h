@@ -0,0 +1,89 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file sim_source.h
+//
+// FILENAME: sim_source.h
+//
+// DESCRIPTION: Defines the Sim_Source class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef SIM_SOURCE_H_
+#define SIM_SOURCE_H_
+
+#include "includes.h"
+#include "sample_source.h"
+
+/*! \ingroup STRUCTS
+ *  @brief One simulated satellite, the ground truth and the state of its NCOs */
+typedef struct Sim_SV_S
+{
+
+	int32	sv;					//!< PRN (0 based)
+	double	cn0;				//!< C/N0 (dB-Hz)
+	double	doppler;			//!< Current Doppler (Hz)
+	double	doppler_rate;		//!< Doppler rate (Hz/s)
+	double	code_delay;			//!< Chips from the first sample to the first code epoch
+	uint32	carr_phase;			//!< Carrier NCO, 2^32 is a cycle
+	uint64	code_phase;			//!< Code NCO, 2^32 is a chip
+	int32	epochs;				//!< Code periods since the last data bit
+	uint32	data;				//!< Data bit generator
+	int16	bit;				//!< Current data bit, 0 or 1
+	int16	code[CODE_CHIPS];	//!< The code as 0 or 1
+	CPX		lut[1 << SIM_LUT_BITS];	//!< Carrier at this SV's amplitude
+
+} Sim_SV_S;
+
+/*! \ingroup CLASSES
+ *  @brief Synthesizes the IF at 2.048 Msps: a set of satellites, each with its own C/N0, Doppler, Doppler
+ *  rate, code delay, and 50 bps data, on top of Gaussian noise. Everything is built at 2^SIM_SHIFT
+ *  times the output scale, summed with sse_add, then shifted down. The noise is drawn sample by sample
+ *  from a Gaussian pool filled at startup, so it is white across integrations of any length.
+ */
+class Sim_Source : public Sample_Source
+{
+
+	private:
+
+		Sim_SV_S *svs;				//!< The satellites
+		int32 nsv;					//!< Number of satellites
+		int32 ants;					//!< Every antenna gets the same signal
+		CPX *noise;					//!< 2^SIM_NOISE_BITS samples of noise
+		CPX replica[SAMPS_MS];		//!< One satellite's ms
+		uint32 rng;					//!< Picks the noise samples
+		int64 played;				//!< Ms generated, for pacing
+		struct timeval t0;			//!< Wall clock at the first ms
+		char name[1024];			//!< The spec
+
+		bool Scenario(const char *_spec);	//!< Parse a count or a scenario file
+		void Setup(Sim_SV_S *_s);			//!< Code, amplitude, and starting phases
+		void Generate(Sim_SV_S *_s);		//!< Add one ms of a satellite to the replica
+		uint32 Random();					//!< xorshift32
+
+	public:
+
+		Sim_Source(const char *_spec, int32 _ants);
+		~Sim_Source();
+		bool isOpen(){return(nsv > 0);}
+		bool Read(ms_packet *_p);
+		const char *getName(){return(name);}
+};
+
+#endif /* SIM_SOURCE_H_ */
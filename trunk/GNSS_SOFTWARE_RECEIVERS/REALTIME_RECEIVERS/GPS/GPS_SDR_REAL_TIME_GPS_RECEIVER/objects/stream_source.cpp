@@ -0,0 +1,379 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file stream_source.cpp
+//
+// FILENAME: stream_source.cpp
+//
+// DESCRIPTION: Implements member functions of the Stream_Source class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include <sys/socket.h>
+#include <netdb.h>
+
+#include "stream_source.h"
+#include "gps_source.h"
+
+/*----------------------------------------------------------------------------------------------*/
+Stream_Source::Stream_Source(int32 _type, const char *_addr, int32 _ants)
+{
+
+	type = _type;
+	fd = -1;
+	ants = _ants;
+	bits = 16;
+	bytes_ms = SAMPS_MS*sizeof(CPX);
+	have = pos = 0;
+	batch = new uint8[STREAM_BATCH];
+
+	snprintf(name, 1024, "%s%s", (type == STREAM_TCP) ? "tcp:" : (type == STREAM_UDP) ? "udp:" : "", _addr);
+
+	switch(type)
+	{
+		case STREAM_TCP:
+			Connect(_addr);
+			break;
+		case STREAM_UDP:
+			Bind(_addr);
+			break;
+		default:
+			/* Work on a copy of stdin so closing it is harmless */
+			if(strcmp(_addr, "-") == 0)
+				fd = dup(STDIN_FILENO);
+			else
+				fd = open(_addr, O_RDONLY);
+#ifdef F_SETPIPE_SZ
+			if(fd != -1)
+				fcntl(fd, F_SETPIPE_SZ, STREAM_BATCH);
+#endif
+			break;
+	}
+
+	if(fd == -1)
+	{
+		fprintf(stderr,"Could not open %s\n",name);
+		return;
+	}
+
+	/* Only a byte stream can carry a header */
+	if((type != STREAM_UDP) && !Header())
+	{
+		fprintf(stderr,"Unsupported sample stream %s\n",name);
+		close(fd);
+		fd = -1;
+		return;
+	}
+
+	if(gopt.verbose)
+		fprintf(stdout,"Reading %d bit samples from %s\n",bits,name);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Stream_Source::~Stream_Source()
+{
+
+	if(fd != -1)
+		close(fd);
+
+	delete [] batch;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Stream_Source::Connect(const char *_addr)
+{
+
+	char host[1024];
+	char *port;
+	int32 size;
+	struct addrinfo hints, *res, *ai;
+
+	strncpy(host, _addr, 1023);
+	host[1023] = '\0';
+
+	port = strrchr(host, ':');
+	if(port == NULL)
+		return(false);
+	*port++ = '\0';
+
+	memset(&hints, 0x0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	if(getaddrinfo(host, port, &hints, &res) != 0)
+		return(false);
+
+	for(ai = res; ai != NULL; ai = ai->ai_next)
+	{
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if(fd == -1)
+			continue;
+
+		/* Let the kernel soak up scheduling hiccups */
+		size = STREAM_RCVBUF;
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+		if(connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+
+	return(fd != -1);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Stream_Source::Bind(const char *_addr)
+{
+
+	char host[1024];
+	char *port;
+	int32 size;
+	struct addrinfo hints, *res, *ai;
+
+	strncpy(host, _addr, 1023);
+	host[1023] = '\0';
+
+	/* Just a port binds every interface */
+	port = strrchr(host, ':');
+	if(port != NULL)
+		*port++ = '\0';
+	else
+		port = host;
+
+	memset(&hints, 0x0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_PASSIVE;
+
+	if(getaddrinfo((port == host) ? NULL : host, port, &hints, &res) != 0)
+		return(false);
+
+	for(ai = res; ai != NULL; ai = ai->ai_next)
+	{
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if(fd == -1)
+			continue;
+
+		size = STREAM_RCVBUF;
+		setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+		if(bind(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+
+	return(fd != -1);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Stream_Source::Header()
+{
+
+	IF_File_Header_S header;
+
+	while(have - pos < (int32)sizeof(IF_File_Header_S))
+		if(!Fill())
+			return(false);
+
+	memcpy(&header, &batch[pos], sizeof(IF_File_Header_S));
+	if(header.magic != IF_FILE_MAGIC)
+		return(true);
+
+	if((header.version != IF_FILE_VERSION) || (header.samps_ms != SAMPS_MS) ||
+	   ((header.bits != 2) && (header.bits != 4) && (header.bits != 8) && (header.bits != 16)))
+		return(false);
+
+	bits = header.bits;
+	bytes_ms = SAMPS_MS*2*bits/8;
+	pos += sizeof(IF_File_Header_S);
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+int32 Stream_Source::Receive(uint8 *_dst, int32 _bytes)
+{
+
+	int32 n;
+
+	do
+	{
+		if(type == STREAM_PIPE)
+			n = read(fd, _dst, _bytes);
+		else
+			n = recv(fd, _dst, _bytes, 0);
+	}
+	while((n == -1) && (errno == EINTR));
+
+	return((n > 0) ? n : -1);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Fill: Append to the staging buffer with as few calls as possible. A byte stream hands back whatever
+ * is already queued in one read, a UDP socket is drained of every datagram that is waiting.
+ * */
+bool Stream_Source::Fill()
+{
+
+	int32 n;
+
+	if(pos == have)
+		pos = have = 0;
+
+	n = Receive(&batch[have], STREAM_BATCH - have);
+	if(n == -1)
+		return(false);
+	have += n;
+
+	if(type == STREAM_UDP)
+	{
+		while(STREAM_BATCH - have >= STREAM_MAX_DGRAM)
+		{
+			n = recv(fd, &batch[have], STREAM_BATCH - have, MSG_DONTWAIT);
+			if(n <= 0)
+				break;
+			have += n;
+		}
+	}
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+bool Stream_Source::Get(uint8 *_dst, int32 _bytes)
+{
+
+	int32 n;
+
+	while(_bytes > 0)
+	{
+		if(pos == have)
+		{
+			/* Nothing staged, a byte stream can go straight to the destination */
+			if(type != STREAM_UDP)
+			{
+				n = Receive(_dst, _bytes);
+				if(n == -1)
+					return(false);
+
+				_dst += n;
+				_bytes -= n;
+				continue;
+			}
+
+			if(!Fill())
+				return(false);
+		}
+
+		n = (have - pos < _bytes) ? (have - pos) : _bytes;
+		memcpy(_dst, &batch[pos], n);
+		pos += n;
+		_dst += n;
+		_bytes -= n;
+	}
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Read: Raw samples land directly in the slot. Packed ones are unpacked out of the staging buffer,
+ * only a ms that straddles two batches is gathered into scratch first.
+ * */
+bool Stream_Source::Read(ms_packet *_p)
+{
+
+	int32 lcv;
+	uint8 *src;
+
+	for(lcv = 0; lcv < ants; lcv++)
+	{
+		if(bits == 16)
+		{
+			if(!Get((uint8 *)&_p->data[lcv][0], bytes_ms))
+				return(false);
+			continue;
+		}
+
+		if((pos == have) && !Fill())
+			return(false);
+
+		if(have - pos >= bytes_ms)
+		{
+			src = &batch[pos];
+			pos += bytes_ms;
+		}
+		else
+		{
+			if(!Get(scratch, bytes_ms))
+				return(false);
+			src = scratch;
+		}
+
+		switch(bits)
+		{
+			case 8:
+				sse_unpack8((int8 *)src, &_p->data[lcv][0], SAMPS_MS);
+				break;
+			case 4:
+				sse_unpack4(src, &_p->data[lcv][0], SAMPS_MS);
+				break;
+			default:
+				sse_unpack2(src, &_p->data[lcv][0], SAMPS_MS);
+				break;
+		}
+	}
+
+	return(true);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,79 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file stream_source.h
+//
+// FILENAME: stream_source.h
+//
+// DESCRIPTION: Defines the Stream_Source class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef STREAM_SOURCE_H_
+#define STREAM_SOURCE_H_
+
+#include "includes.h"
+#include "sample_source.h"
+
+enum STREAM_TYPE
+{
+	STREAM_TCP,
+	STREAM_UDP,
+	STREAM_PIPE
+};
+
+/*! \ingroup CLASSES
+ *  @brief Samples from a socket, a pipe, or stdin, in the recorder's format: every ms holds each
+ *  antenna's SAMPS_MS samples in turn. A TCP or pipe stream may start with an IF_File_Header_S to send
+ *  packed samples, otherwise (and always over UDP) they are 16 bit CPX. Raw samples are read straight
+ *  into the FIFO slot, packed ones are fetched STREAM_BATCH bytes at a time and unpacked into it.
+ */
+class Stream_Source : public Sample_Source
+{
+
+	private:
+
+		int32 type;					//!< STREAM_TCP, STREAM_UDP, or STREAM_PIPE
+		int32 fd;					//!< Socket or pipe, -1 if not open
+		int32 ants;					//!< Antennas per ms
+		int32 bits;					//!< Bits per I or Q
+		int32 bytes_ms;				//!< Bytes per ms per antenna
+		uint8 *batch;				//!< Staging buffer, STREAM_BATCH bytes
+		int32 have;					//!< Bytes in the staging buffer
+		int32 pos;					//!< Bytes of the staging buffer used
+		uint8 scratch[SAMPS_MS*sizeof(CPX)];	//!< A packed ms that straddles two batches
+		char name[1024];			//!< The spec
+
+		bool Connect(const char *_addr);	//!< Open a TCP connection
+		bool Bind(const char *_addr);		//!< Open a UDP socket
+		bool Header();						//!< Look for an IF_File_Header_S
+		int32 Receive(uint8 *_dst, int32 _bytes);	//!< One read or recv, -1 at the end of the stream
+		bool Fill();						//!< Refill the staging buffer
+		bool Get(uint8 *_dst, int32 _bytes);	//!< Get exactly _bytes
+
+	public:
+
+		Stream_Source(int32 _type, const char *_addr, int32 _ants);
+		~Stream_Source();
+		bool isOpen(){return(fd != -1);}
+		bool Read(ms_packet *_p);
+		const char *getName(){return(name);}
+};
+
+#endif /* STREAM_SOURCE_H_ */
@@ -66,6 +66,7 @@ SV_Select::SV_Select():Threaded_Object("SVSTASK")
 
 	strong_sv = 0;
 	weak_sv = 0;
+	weak_cursor = 0;
 	type = ACQ_TYPE_STRONG;
 	mode = ACQ_MODE_COLD;
 	mask_angle = PI/2;
@@ -74,6 +75,7 @@ SV_Select::SV_Select():Threaded_Object("SVSTASK")
 	pnav->stale_ticks 		= STALE_SPS_VALUE;
 
 	config.weak_modulo		= ACQ_MODULO_WEAK;
+	config.weak_budget		= ACQ_BUDGET_WEAK;
 	config.warm_doppler 	= MAX_DOPPLER_WARM;
 	config.weak_doppler 	= MAX_DOPPLER_WEAK;
 	config.strong_doppler 	= MAX_DOPPLER_STRONG;
@@ -138,6 +140,10 @@ void SV_Select::Import()
 	if(acqs_per_pvt < 1)
 		acqs_per_pvt = 1;
 
+	/* One at a time while the correlator is struggling */
+	if(pOverload->getLevel() >= OVERLOAD_STRETCH)
+		acqs_per_pvt = 1;
+
 	/* Multiple acqs in some cases */
 	for(k = 0; k < acqs_per_pvt; k++)
 	{
@@ -195,9 +201,11 @@ void SV_Select::Acquire()
 	int32 already;
 	int32 current_sv;
 	int32 doacq;
+	int32 busy;
 
 	chan = 666;
 	already = 666;
+	busy = 0;
 
 	switch(type)
 	{
@@ -217,14 +225,22 @@ void SV_Select::Acquire()
 		{
 			chan = lcv;
 		}
-		else if(pChannels[lcv]->getSV() == current_sv)
+		else
 		{
-			already = lcv;
-			sv_prediction[current_sv].tracked = true;
+			busy++;
+			if(pChannels[lcv]->getSV() == current_sv)
+			{
+				already = lcv;
+				sv_prediction[current_sv].tracked = true;
+			}
 		}
 		pChannels[lcv]->Unlock();
 	}
 
+	/* The overload controller may be holding channels back */
+	if(busy >= pOverload->getCap())
+		chan = 666;
+
 	/* Up to date PVT */
 	//read(PVT_2_SVS_P[READ], &pvt_s, sizeof(PVT_2_SVS_S));
 
@@ -249,7 +265,12 @@ void SV_Select::Acquire()
 		/* Wait for acq to return, do stuff depending on the state */
 		read(ACQ_2_SVS_P[READ], &command, sizeof(Acq_Command_S));
 
-		if(command.success)
+		/* A preempted weak search is resumed from its cursor next time around, a cancelled strong
+		 * search's cursor is a spiral step and means nothing to the weak pass */
+		if(command.partial && ((command.type == ACQ_TYPE_WEAK) || (command.type == ACQ_TYPE_MEDIUM)))
+			weak_cursor = command.cursor;
+
+		if(command.success && !command.partial)
 			write(SVS_2_COR_P[WRITE], &command, sizeof(Acq_Command_S));
 	}
 
@@ -302,6 +323,16 @@ uint32 SV_Select::SetupRequest(int32 _sv)
 	command.maxdopp 	= mdoppler;
 	command.accel		= 0;
 	command.success		= false;
+	command.partial		= false;
+	command.budget		= 0;
+	command.cursor		= 0;
+
+	/* Weak searches are time sliced so strong/warm ones never wait long behind them */
+	if(type != ACQ_TYPE_STRONG)
+	{
+		command.budget = config.weak_budget;
+		command.cursor = weak_cursor;
+	}
 
 	/* Set maximum Doppler bounds and return based on acquisition type */
     if(type == ACQ_TYPE_STRONG)
@@ -323,6 +354,10 @@ uint32 SV_Select::SetupRequest(int32 _sv)
     	/* Turned off for cold start */
     	if((config.weak_operation == ACQ_OPERATION_WARM) && (mode == ACQ_MODE_COLD))
     		return_val = false;
+
+    	/* First to go when the correlator falls behind */
+    	if(pOverload->getLevel() >= OVERLOAD_PAUSE)
+    		return_val = false;
 	}
 
 	/* Only update prediction if it is longer than 30 seconds old */
@@ -407,8 +442,16 @@ void SV_Select::UpdateState()
 		if(strong_sv == 0)
 			type = ACQ_TYPE_WEAK;
 	}
+	else if(command.partial)
+	{
+		/* Let the strong searches have a turn, then resume this SV */
+		type = ACQ_TYPE_STRONG;
+	}
 	else
 	{
+		/* This pass is done (or was skipped), the next one starts from the first cell */
+		weak_cursor = 0;
+
 		if(command.evenodd == 0)
 		{
 			command.evenodd = 1;
@@ -31,6 +31,7 @@
 #include "includes.h"
 #include "ephemeris.h"
 #include "channel.h"
+#include "overload.h"
 #define EKF_STATE_INITIALIZED (1)
 
 enum SV_SELECT_MODE
@@ -44,7 +45,8 @@ enum SV_SELECT_TYPE
 {
 	ACQ_TYPE_STRONG,		//!< Strong acquisition
 	ACQ_TYPE_MEDIUM,		//!< Medium acquisition
-	ACQ_TYPE_WEAK			//!< Weak acquisition
+	ACQ_TYPE_WEAK,			//!< Weak acquisition
+	ACQ_TYPE_FINE			//!< Strong acquisition with refined Doppler
 };
 
 enum SV_SELECT_OPERATION
@@ -85,6 +87,7 @@ class SV_Select : public Threaded_Object
 		int32				type;							//!< WEAK or STRONG
 		int32				strong_sv;						//!< The current strong SV
 		int32				weak_sv;						//!< The current weak SV
+		int32				weak_cursor;					//!< Where the preempted weak search left off
 		int32				acq_ticks;						//!< Number of acq ticks
 		float				mask_angle;						//!< Elevation mask angle
 
@@ -558,7 +558,7 @@ void Telemetry::Export()
 void Telemetry::SendBoardHealth()
 {
 
-	int32 lcv;
+	int32 lcv, fill, fill_hi, fill_lo;
 	uint32 shu;
 
 	Board_Health_M *board_health = &message_body.board_health;
@@ -569,17 +569,21 @@ void Telemetry::SendBoardHealth()
 	board_health->fft_version = 0;
 
 	/* DSA Values */
-	board_health->dsa0 = pSource->getScale();
-	board_health->dsa1 = 0;
+	board_health->dsa0 = pSource->getScale(0);
+	board_health->dsa1 = pSource->getScale(1);
 	board_health->dsa2 = 0;
 	board_health->dsa3 = 0;
 
 	/* Overflow on A/Ds */
-	board_health->ovrflw0 = pSource->getOvrflw();
-	board_health->ovrflw1 = 0;
+	board_health->ovrflw0 = pSource->getOvrflw(0);
+	board_health->ovrflw1 = pSource->getOvrflw(1);
 	board_health->ovrflw2 = 0;
 	board_health->ovrflw3 = 0;
 
+	/* Sample magnitudes */
+	memcpy(board_health->agc_hist0, pSource->getHist(0), AGC_HIST_BINS*sizeof(uint32));
+	memcpy(board_health->agc_hist1, pSource->getHist(1), AGC_HIST_BINS*sizeof(uint32));
+
 	/* LO Status Bit */
 	board_health->lo_locked = 0;
 
@@ -600,6 +604,53 @@ void Telemetry::SendBoardHealth()
 	for(lcv = 0; lcv < SHU_SIGNALS; lcv++)
 		board_health->adc_values[lcv] = adc_values[lcv];
 
+	/* Recorder */
+	if(pRecorder != NULL)
+	{
+		board_health->rec_ms = pRecorder->getWritten();
+		board_health->rec_drops = pRecorder->getDrops();
+		board_health->rec_latency = pRecorder->getLatency();
+		board_health->rec_latency_max = pRecorder->getLatencyMax();
+	}
+	else
+	{
+		board_health->rec_ms = 0;
+		board_health->rec_drops = 0;
+		board_health->rec_latency = 0;
+		board_health->rec_latency_max = 0;
+	}
+
+	/* FIFO fill level */
+	pFIFO->getFill(&fill, &fill_hi, &fill_lo);
+	board_health->fifo_depth = pFIFO->getDepth();
+	board_health->fifo_fill = fill;
+	board_health->fifo_fill_hi = fill_hi;
+	board_health->fifo_fill_lo = fill_lo;
+	board_health->fifo_huge = pFIFO->getHuge();
+
+	/* USB streaming */
+	board_health->usb_blocks = pSource->getUSBBlocks();
+	board_health->usb_overruns = pSource->getUSBOverruns();
+	board_health->usb_errors = pSource->getUSBErrors();
+
+	/* Load shedding */
+	board_health->load_level = pOverload->getLevel();
+	board_health->load_cap = pOverload->getCap();
+	board_health->load_util = pOverload->getUtil();
+	board_health->load_sheds = pOverload->getSheds();
+
+	/* Channel trace */
+	if(pTracer != NULL)
+	{
+		board_health->trace_records = pTracer->getWritten();
+		board_health->trace_drops = pTracer->getDrops();
+	}
+	else
+	{
+		board_health->trace_records = 0;
+		board_health->trace_drops = 0;
+	}
+
 	board_health->tic = pvt_s.sps.tic;
 
 	/* Form the packet header */
@@ -702,9 +753,10 @@ void Telemetry::SendChannelHealth()
 		channel->count 		= aChannel->count;		//!< Number of accumulations that have been processed
 		channel->subframe	= aChannel->subframe;	//!< Current subframe number
 		channel->best_epoch = aChannel->best_epoch;	//!< Best estimate of bit edge position
-		channel->w 			= aChannel->aPLL.w*4096.0;						//!< 3rd order PLL state
-		channel->x 			= aChannel->aPLL.x*4096.0;						//!< 3rd order PLL state
-		channel->z 			= aChannel->aPLL.z*4096.0;						//!< 3rd order PLL state
+		channel->pull_in	= aChannel->pull_in;	//!< Time to frequency lock
+		channel->w 			= pLoops->getW(lcv)*4096.0;					//!< 3rd order PLL state
+		channel->x 			= pLoops->getX(lcv)*4096.0;					//!< 3rd order PLL state
+		channel->z 			= pLoops->getZ(lcv)*4096.0;					//!< 3rd order PLL state
 		channel->code_nco 	= aChannel->code_nco*HZ_2_NCO_CODE_INCR;		//!< State of code_nco
 		channel->carrier_nco = aChannel->carrier_nco*HZ_2_NCO_CARR_INCR;	//!< State of carrier_nco
 
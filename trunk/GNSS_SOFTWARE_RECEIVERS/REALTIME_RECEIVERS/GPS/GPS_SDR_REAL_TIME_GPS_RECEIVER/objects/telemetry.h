@@ -45,6 +45,8 @@ enum Telemetry_Type
 #include "correlator.h"
 #include "acquisition.h"		//!< Interact with and direct acquisition engine
 #include "ephemeris.h"			//!< Decode almanac/ephemeris/utc
+#include "recorder.h"			//!< Recorder health
+#include "tracer.h"				//!< Channel trace health
 #include "sv_select.h"			//!< Maintain state of GPS constellation using almanac data
 #include "pvt.h"				//!< Least squares PVT solution
 //#include "pps.h"				//!< Control the PPS
@@ -229,8 +229,13 @@ void Threaded_Object::IncExecTic()
 void Threaded_Object::IncStartTic()
 {
 	#ifdef LINUX_OS
-		gettimeofday(&tv, NULL);
-		temp_start_tic = 100*(tv.tv_sec - starttime.tv_sec) + (tv.tv_usec - starttime.tv_usec)/10000;
+		if(gopt.realtime)
+		{
+			gettimeofday(&tv, NULL);
+			temp_start_tic = 100*(tv.tv_sec - starttime.tv_sec) + (tv.tv_usec - starttime.tv_usec)/10000;
+		}
+		else
+			temp_start_tic = gclock/10;
 	#endif
 
 	#ifdef NUCLEUS_OS
@@ -244,8 +249,13 @@ void Threaded_Object::IncStartTic()
 void Threaded_Object::IncStopTic()
 {
 	#ifdef LINUX_OS
-		gettimeofday(&tv, NULL);
-		stop_tic = 100*(tv.tv_sec - starttime.tv_sec) + (tv.tv_usec - starttime.tv_usec)/10000;
+		if(gopt.realtime)
+		{
+			gettimeofday(&tv, NULL);
+			stop_tic = 100*(tv.tv_sec - starttime.tv_sec) + (tv.tv_usec - starttime.tv_usec)/10000;
+		}
+		else
+			stop_tic = gclock/10;
 		start_tic = temp_start_tic;
 	#endif
 
@@ -0,0 +1,287 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file tracer.cpp
+//
+// FILENAME: tracer.cpp
+//
+// DESCRIPTION: Implements member functions of the Tracer class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#include "tracer.h"
+
+/*----------------------------------------------------------------------------------------------*/
+void *Tracer_Thread(void *_arg)
+{
+
+	Tracer *aTracer = pTracer;
+
+	while(grun)
+	{
+		usleep(TRACE_PERIOD_MS*1000);
+		aTracer->Drain();
+		aTracer->IncExecTic();
+	}
+
+	pthread_exit(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Tracer::Start()
+{
+
+	Start_Thread(Tracer_Thread, NULL);
+
+	if(gopt.verbose)
+		fprintf(stdout,"Tracer thread started\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+Tracer::Tracer():Threaded_Object("TRCTASK")
+{
+
+	Trace_File_Header_S header;
+
+	offset = 0;
+	fill = 0;
+	blocks = 0;
+	written = 0;
+
+	if(posix_memalign((void **)&rings, 64, MAX_CHANNELS*sizeof(Trace_Ring_S)) != 0)
+	{
+		fprintf(stderr,"Could not allocate the trace rings, aborting.\n");
+		exit(1);
+	}
+	memset(rings, 0x0, MAX_CHANNELS*sizeof(Trace_Ring_S));
+
+	buff = new uint8[TRACE_BUFF_SIZE];
+
+	index_size = 1024;
+	index = (Trace_Block_S *)malloc(index_size*sizeof(Trace_Block_S));
+
+	fd = open("./channels.trc", O_WRONLY | O_CREAT | O_TRUNC | O_LARGEFILE, 0644);
+	if(fd == -1)
+		fprintf(stderr,"Could not open ./channels.trc, not tracing the channels\n");
+	else
+		fprintf(stdout,"./channels.trc opened\n");
+	fflush(stdout);
+
+	memset(&header, 0x0, sizeof(Trace_File_Header_S));
+	header.magic		= TRACE_FILE_MAGIC;
+	header.version		= TRACE_FILE_VERSION;
+	header.record_size	= sizeof(Trace_Record_S);
+	header.channels		= MAX_CHANNELS;
+	header.ring			= TRACE_RING;
+
+	Append(&header, sizeof(Trace_File_Header_S));
+
+	if(gopt.verbose)
+		fprintf(stdout,"Creating Tracer\n");
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * ~Tracer: The channels are gone by now, pick up the last of the rings then write the index and the
+ * footer.
+ * */
+Tracer::~Tracer()
+{
+
+	Trace_Footer_S footer;
+
+	Drain();
+
+	footer.magic	= TRACE_INDEX_MAGIC;
+	footer.blocks	= blocks;
+	footer.offset	= offset + fill;
+
+	Append(index, blocks*sizeof(Trace_Block_S));
+	Append(&footer, sizeof(Trace_Footer_S));
+	Flush();
+
+	if(fd != -1)
+		close(fd);
+
+	if(gopt.verbose)
+		fprintf(stdout,"Destructing Tracer, %u records traced, %u dropped\n", written, getDrops());
+
+	free(index);
+	free(rings);
+	delete [] buff;
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Drain: Each channel with something in its ring becomes one block. The records are copied out
+ * before tail is advanced, so the producer can never overwrite one still being read.
+ * */
+void Tracer::Drain()
+{
+
+	int32 lcv, n, first;
+	uint32 head, tail;
+	Trace_Ring_S *r;
+	Trace_Block_S *block;
+
+	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
+	{
+		r = &rings[lcv];
+		tail = r->tail;
+		head = r->head;
+		TRACE_BARRIER();
+
+		if(head == tail)
+			continue;
+
+		if(blocks == index_size)
+		{
+			index_size *= 2;
+			index = (Trace_Block_S *)realloc(index, index_size*sizeof(Trace_Block_S));
+		}
+
+		block = &index[blocks++];
+		block->magic		= TRACE_BLOCK_MAGIC;
+		block->chan			= lcv;
+		block->records		= head - tail;
+		block->first_tic	= r->records[tail & TRACE_MASK].tic;
+		block->last_tic		= r->records[(head - 1) & TRACE_MASK].tic;
+		block->drops		= r->drops;
+		block->offset		= offset + fill;
+
+		Append(block, sizeof(Trace_Block_S));
+
+		/* The ring may wrap within the block */
+		while(tail != head)
+		{
+			first = tail & TRACE_MASK;
+			n = head - tail;
+			if(n > TRACE_RING - first)
+				n = TRACE_RING - first;
+
+			Append(&r->records[first], n*sizeof(Trace_Record_S));
+			tail += n;
+		}
+
+		written += block->records;
+
+		TRACE_BARRIER();
+		r->tail = tail;
+	}
+
+	Flush();
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+uint32 Tracer::getDrops()
+{
+
+	int32 lcv;
+	uint32 drops;
+
+	drops = 0;
+	for(lcv = 0; lcv < MAX_CHANNELS; lcv++)
+		drops += rings[lcv].drops;
+
+	return(drops);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void Tracer::Append(void *_src, int32 _bytes)
+{
+
+	int32 done, n;
+
+	done = 0;
+	while(done < _bytes)
+	{
+		n = TRACE_BUFF_SIZE - fill;
+		if(n > _bytes - done)
+			n = _bytes - done;
+
+		memcpy(&buff[fill], (uint8 *)_src + done, n);
+
+		fill += n;
+		done += n;
+
+		if(fill == TRACE_BUFF_SIZE)
+			Flush();
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Flush: Write out the buffer, the offsets in the index count every byte appended, written or not,
+ * so a failed write only loses the trace from there on.
+ * */
+void Tracer::Flush()
+{
+
+	int32 state, done, n;
+
+	if(fill == 0)
+		return;
+
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
+
+	done = 0;
+	while((fd != -1) && (done < fill))
+	{
+		n = write(fd, &buff[done], fill - done);
+		if(n <= 0)
+		{
+			if((n == -1) && (errno == EINTR))
+				continue;
+
+			fprintf(stderr,"Trace write failed (%s), closing the file\n",strerror(errno));
+			close(fd);
+			fd = -1;
+			break;
+		}
+		done += n;
+	}
+
+	offset += fill;
+	fill = 0;
+
+	pthread_setcancelstate(state, NULL);
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -0,0 +1,186 @@
+/*----------------------------------------------------------------------------------------------*/
+/*! \file tracer.h
+//
+// FILENAME: tracer.h
+//
+// DESCRIPTION: Defines the Tracer class.
+//
+// DEVELOPERS: Gregory W. Heckler (2003-2009)
+//
+// LICENSE TERMS: Copyright (c) Gregory W. Heckler 2009
+//
+// This file is part of the GPS Software Defined Radio (GPS-SDR)
+//
+// The GPS-SDR is free software; you can redistribute it and/or modify it under the terms of the
+// GNU General Public License as published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version. The GPS-SDR is distributed in the hope that
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// Note:  Comments within this file follow a syntax that is compatible with
+//        DOXYGEN and are utilized for automated document extraction
+//
+// Reference:
+*/
+/*----------------------------------------------------------------------------------------------*/
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include "includes.h"
+
+#define TRACE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+#define TRACE_FILE_MAGIC	(0x52545347)	//!< "GSTR"
+#define TRACE_BLOCK_MAGIC	(0x4B4C4254)	//!< "TBLK"
+#define TRACE_INDEX_MAGIC	(0x58444954)	//!< "TIDX"
+#define TRACE_FILE_VERSION	(1)				//!< Bump if Trace_Record_S changes
+
+#define TRACE_RING			(1 << TRACE_RING_BITS)	//!< Records per channel ring
+#define TRACE_MASK			(TRACE_RING - 1)
+
+#define TRACE_BIT_LOCK		(0x1)			//!< Trace_Record_S::flags
+#define TRACE_FRAME_LOCK	(0x2)
+#define TRACE_FREQ_LOCK		(0x4)
+#define TRACE_NAVIGATE		(0x8)
+
+/*! \ingroup STRUCTS
+ *  @brief One dump of a tracking channel, 80 bytes */
+typedef struct Trace_Record_S
+{
+
+	uint32	tic;				//!< FIFO count of the ms the dump was made on
+	int32	count;				//!< Accumulations processed by the channel
+	uint8	chan;				//!< Channel number
+	uint8	sv;					//!< SV/PRN (0 based)
+	uint8	state;				//!< Channel_State
+	uint8	len;				//!< Accumulation length (ms)
+	uint8	flags;				//!< TRACE_BIT_LOCK | TRACE_FRAME_LOCK | TRACE_FREQ_LOCK | TRACE_NAVIGATE
+	uint8	antenna;			//!< Antenna
+	uint8	subframe;			//!< Current subframe
+	uint8	best_epoch;			//!< Bit edge estimate
+	int32	I[3];				//!< Early, prompt, and late inphase correlations
+	int32	Q[3];				//!< Early, prompt, and late quadrature correlations
+	double	carrier_nco;		//!< Carrier NCO (Hz)
+	double	code_nco;			//!< Code NCO (chips/s)
+	float	cn0;				//!< C/N0 estimate (dB-Hz)
+	float	p_avg;				//!< Filtered prompt power
+	float	w;					//!< PLL states
+	float	x;
+	float	z;
+	int32	pull_in;			//!< ms from channel start to frequency lock, -1 until locked
+
+} Trace_Record_S;
+
+/*! \ingroup STRUCTS
+ *  @brief Start of a trace file */
+typedef struct Trace_File_Header_S
+{
+
+	uint32	magic;				//!< TRACE_FILE_MAGIC
+	uint32	version;			//!< TRACE_FILE_VERSION
+	int32	record_size;		//!< sizeof(Trace_Record_S)
+	int32	channels;			//!< MAX_CHANNELS
+	int32	ring;				//!< TRACE_RING
+	int32	pad[11];
+
+} Trace_File_Header_S;
+
+/*! \ingroup STRUCTS
+ *  @brief Heads each run of records from one channel, the records follow it. Also the entry of the
+ *  index at the end of the file, where offset locates the block. */
+typedef struct Trace_Block_S
+{
+
+	uint32	magic;				//!< TRACE_BLOCK_MAGIC
+	int32	chan;				//!< Channel the records came from
+	int32	records;			//!< Number of records in the block
+	uint32	first_tic;			//!< tic of the first record
+	uint32	last_tic;			//!< tic of the last record
+	uint32	drops;				//!< Records the channel had dropped when the block was written
+	int64	offset;				//!< File offset of the block header
+
+} Trace_Block_S;
+
+/*! \ingroup STRUCTS
+ *  @brief Last thing in a cleanly closed trace file, locates the index. A file cut short by a crash has
+ *  no footer, walk the block headers instead. */
+typedef struct Trace_Footer_S
+{
+
+	uint32	magic;				//!< TRACE_INDEX_MAGIC
+	int32	blocks;				//!< Entries in the index
+	int64	offset;				//!< File offset of the index
+
+} Trace_Footer_S;
+
+/*! \ingroup STRUCTS
+ *  @brief Single producer (the correlator), single consumer (the Tracer thread) ring of records. The
+ *  producer only writes head, the consumer only writes tail, they are kept on separate cache lines. */
+typedef struct Trace_Ring_S
+{
+
+	volatile uint32	head;		//!< Count of records pushed
+	uint32	pad0[15];
+	volatile uint32	tail;		//!< Count of records drained
+	uint32	pad1[15];
+	volatile uint32	drops;		//!< Records lost because the ring was full
+	uint32	pad2[15];
+	Trace_Record_S	records[TRACE_RING];
+
+} Trace_Ring_S;
+
+/*! \ingroup CLASSES
+ *  @brief Binary channel trace for the -c option. Each channel pushes a record per dump into its own
+ *  lock-free ring, never touching the disk. The thread drains the rings every TRACE_PERIOD_MS into
+ *  ./channels.trc as blocks of records, and on close appends an index of the blocks. Use gps-trace
+ *  (accessories/gps-trace.cpp) to convert the file.
+ */
+class Tracer : public Threaded_Object
+{
+
+	private:
+
+		Trace_Ring_S *rings;			//!< One ring per channel
+		int32 fd;						//!< Output file
+		int64 offset;					//!< Bytes written
+		uint8 *buff;					//!< Write buffer, TRACE_BUFF_SIZE bytes
+		int32 fill;						//!< Bytes in the write buffer
+		Trace_Block_S *index;			//!< Block headers written so far
+		int32 blocks;					//!< Entries in index
+		int32 index_size;				//!< Allocated entries in index
+		uint32 written;					//!< Records written
+
+		void Append(void *_src, int32 _bytes);	//!< Add to the write buffer
+		void Flush();							//!< Write out the buffer
+
+	public:
+
+		Tracer();
+		~Tracer();
+		void Start();						//!< Start the thread
+		void Drain();						//!< Move whatever is in the rings to the file
+
+		/*! Push a record from the channel's (correlator) thread, drops it if the ring is full */
+		void Push(int32 _chan, Trace_Record_S *_record)
+		{
+			Trace_Ring_S *r = &rings[_chan];
+			uint32 head = r->head;
+
+			if(head - r->tail >= TRACE_RING)
+			{
+				r->drops++;
+				return;
+			}
+
+			r->records[head & TRACE_MASK] = *_record;
+			TRACE_BARRIER();
+			r->head = head + 1;
+		}
+
+		uint32 getWritten(){return(written);}
+		uint32 getDrops();					//!< Records dropped over all channels
+};
+
+#endif /* TRACER_H_ */
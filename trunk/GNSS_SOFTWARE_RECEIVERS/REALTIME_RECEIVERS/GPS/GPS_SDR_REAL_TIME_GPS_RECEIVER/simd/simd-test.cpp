@@ -23,6 +23,7 @@ Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1
 #define GLOBALS_HERE
 
 #include "includes.h"
+#include "gps_source.h"
 
 #define VECTSIZE (10000)
 #define REPEATS	 (100)
@@ -102,6 +103,48 @@ void fill_prn_new(MIX *_vect, int32 _samps)
 
 }
 
+float rand_float(float _min, float _max)
+{
+
+	return(_min + (_max - _min)*(float)rand()/(float)RAND_MAX);
+
+}
+
+
+void fill_loops(Loop_Block_S *_B, int32 _cnt)
+{
+	int32 lcv, lane;
+	Loop_Block_S *b;
+
+	/* Random correlations and state, mixed masks, and some lanes with I == 0 */
+	for(lcv = 0; lcv < _cnt; lcv++)
+	{
+		b = &_B[lcv];
+		for(lane = 0; lane < 4; lane++)
+		{
+			b->ip[lane] = ((rand() & 0x7) == 0) ? 0 : rand_float(-5000, 5000);
+			b->qp[lane] = rand_float(-5000, 5000);
+			b->pe[lane] = rand_float(1, 1e6);
+			b->pl[lane] = rand_float(1, 1e6);
+			b->pll[lane] = (rand() & 0x1) ? -1 : 0;
+			b->pull[lane] = (rand() & 0x1) ? -1 : 0;
+			b->load[lane] = (rand() & 0x3) ? -1 : 0;
+
+			b->kw[lane] = rand_float(0, 1);
+			b->kx[lane] = rand_float(0, 50);
+			b->kz[lane] = rand_float(0, 50);
+			b->kh[lane] = rand_float(0, .01);
+
+			b->w[lane] = rand_float(-100, 100);
+			b->x[lane] = rand_float(-10000, 10000);
+			b->z[lane] = rand_float(-5000, 5000);
+			b->code[lane] = rand_float(-10, 10);
+		}
+	}
+
+}
+
+
 int main(int32 argc, char* argv[])
 {
 
@@ -115,6 +158,9 @@ int main(int32 argc, char* argv[])
 	MIX *testvectf;
 	MIX *testvectg;
 	MIX *testvecth;
+	uint8 *testbytes;
+	Loop_Block_S *testloopa;
+	Loop_Block_S *testloopb;
 
 	int32 err;
 	int32 lcv;
@@ -136,6 +182,11 @@ int main(int32 argc, char* argv[])
 	testvectg = new MIX[VECTSIZE];
 	testvecth = new MIX[VECTSIZE];
 
+	testbytes = new uint8[2*VECTSIZE];
+
+	testloopa = new Loop_Block_S[MAX_CHANNELS];
+	testloopb = new Loop_Block_S[MAX_CHANNELS];
+
 
 
 	/* SIMD ADD */
@@ -549,6 +600,282 @@ int main(int32 argc, char* argv[])
 		fprintf(stdout,"CPX PRN ACCUM NEW\t\tPASSED\n",err);
 	/*----------------------------------------------------------------------------------------------*/
 
+	/* SIMD unpack 8 bit */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	for(lcv = 0; lcv < REPEATS; lcv++)
+	{
+
+		/* Small counts exercise the leftovers */
+		pts = (lcv < 20) ? lcv : rand() % VECTSIZE;
+
+		fill_vect(testvecta, pts);
+
+		x86_pack(testvecta, testbytes, pts, 8, 0);
+		x86_unpack(testbytes, testvectc, pts, 8);
+		sse_unpack8((int8 *)testbytes, testvectd, pts);
+
+		for(lcv2 = 0; lcv2 < pts; lcv2++)
+		{
+			/* Round trip */
+			if(testvecta[lcv2].i != testvectc[lcv2].i)
+				err++;
+
+			if(testvecta[lcv2].q != testvectc[lcv2].q)
+				err++;
+
+			/* SSE vs x86 */
+			if(testvectc[lcv2].i != testvectd[lcv2].i)
+				err++;
+
+			if(testvectc[lcv2].q != testvectd[lcv2].q)
+				err++;
+		}
+
+	}
+	if(err)
+		fprintf(stdout,"UNPACK 8 \t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"UNPACK 8 \t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
+
+	/* SIMD unpack 4 bit */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	for(lcv = 0; lcv < REPEATS; lcv++)
+	{
+
+		pts = (lcv < 20) ? lcv : rand() % VECTSIZE;
+
+		fill_vect(testvecta, pts);
+
+		/* +-16 shifted by 1 fits in 4 bits */
+		x86_pack(testvecta, testbytes, pts, 4, 1);
+		x86_unpack(testbytes, testvectc, pts, 4);
+		sse_unpack4(testbytes, testvectd, pts);
+
+		for(lcv2 = 0; lcv2 < pts; lcv2++)
+		{
+			if((testvecta[lcv2].i >> 1) != testvectc[lcv2].i)
+				err++;
+
+			if((testvecta[lcv2].q >> 1) != testvectc[lcv2].q)
+				err++;
+
+			if(testvectc[lcv2].i != testvectd[lcv2].i)
+				err++;
+
+			if(testvectc[lcv2].q != testvectd[lcv2].q)
+				err++;
+		}
+
+	}
+	if(err)
+		fprintf(stdout,"UNPACK 4 \t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"UNPACK 4 \t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
+
+	/* SIMD pack/unpack 2 bit */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	for(lcv = 0; lcv < REPEATS; lcv++)
+	{
+
+		pts = (lcv < 20) ? lcv : rand() % VECTSIZE;
+
+		fill_vect(testvecta, pts);
+
+		x86_pack(testvecta, testbytes, pts, 2, 2);
+		x86_unpack(testbytes, testvectc, pts, 2);
+		sse_unpack2(testbytes, testvectd, pts);
+
+		for(lcv2 = 0; lcv2 < pts; lcv2++)
+		{
+			if(testvectc[lcv2].i != testvectd[lcv2].i)
+				err++;
+
+			if(testvectc[lcv2].q != testvectd[lcv2].q)
+				err++;
+
+			/* Nearest of -3, -1, +1, +3 */
+			val1 = testvecta[lcv2].i >> 2;
+			val1 = (val1 >= 2) ? 3 : (val1 >= 0) ? 1 : (val1 >= -2) ? -1 : -3;
+			val2 = testvecta[lcv2].q >> 2;
+			val2 = (val2 >= 2) ? 3 : (val2 >= 0) ? 1 : (val2 >= -2) ? -1 : -3;
+
+			if(val1 != testvectc[lcv2].i)
+				err++;
+
+			if(val2 != testvectc[lcv2].q)
+				err++;
+		}
+
+	}
+	if(err)
+		fprintf(stdout,"PACK/UNPACK 2 \t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"PACK/UNPACK 2 \t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
+	/* SIMD AGC */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	for(lcv = 0; lcv < REPEATS; lcv++)
+	{
+
+		pts = (lcv < 20) ? lcv : rand() % VECTSIZE;
+		shift = rand() % 4;
+
+		fill_vect(testvecta, pts);
+
+		memcpy(testvectc, testvecta, pts*sizeof(CPX));
+
+		/* 2 bits leaves plenty of components to count */
+		val1 = run_agc(testvecta, pts, 2, shift);
+		val2 = sse_agc(testvectc, pts, 2, shift);
+
+		if(val1 != val2)
+			err++;
+
+		for(lcv2 = 0; lcv2 < pts; lcv2++)
+		{
+			if(testvecta[lcv2].i != testvectc[lcv2].i)
+				err++;
+
+			if(testvecta[lcv2].q != testvectc[lcv2].q)
+				err++;
+		}
+
+	}
+	if(err)
+		fprintf(stdout,"AGC \t\t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"AGC \t\t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
+	/* SIMD tracking loops */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	for(lcv = 0; lcv < REPEATS; lcv++)
+	{
+
+		float *fa, *fb;
+		float tol;
+
+		pts = 1 + rand() % MAX_CHANNELS;
+
+		fill_loops(testloopa, pts);
+		memcpy(testloopb, testloopa, pts*sizeof(Loop_Block_S));
+
+		x86_loops(testloopa, pts);
+		sse_loops(testloopb, pts);
+
+		/* Single vs double precision atan/sqrt, compare to a relative tolerance */
+		for(lcv2 = 0; lcv2 < pts; lcv2++)
+		{
+			for(shift = 0; shift < 4; shift++)
+			{
+				if(testloopa[lcv2].load[shift] != testloopb[lcv2].load[shift])
+					err++;
+
+				fa = &testloopa[lcv2].w[shift];
+				fb = &testloopb[lcv2].w[shift];
+				for(val1 = 0; val1 < 4; val1++)
+				{
+					tol = 1e-4*(1.0 + fabs(fa[4*val1]));
+					if(fabs(fa[4*val1] - fb[4*val1]) > tol)
+					{
+						fprintf(stdout,"Block %d lane %d state %d: %f,%f\n",lcv2,shift,val1,fa[4*val1],fb[4*val1]);
+						err++;
+					}
+				}
+			}
+		}
+
+	}
+	if(err)
+		fprintf(stdout,"TRACKING LOOPS \t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"TRACKING LOOPS \t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
+	/* File playback, loop a file with a short last window through a deep FIFO */
+	/*----------------------------------------------------------------------------------------------*/
+	err = 0;
+
+	{
+
+		Options_S fopt;
+		GPS_Source *source;
+		ms_packet *packet;
+		CPX **held;
+		CPX tag;
+		int32 fd, ms, depth;
+		char fname[] = "/tmp/simd-test-XXXXXX";
+
+		/* Sparse raw 16 bit file, the first sample of each ms holds its index */
+		ms = FILE_WINDOW_MS + FILE_WINDOW_MS/16 + 37;
+		fd = mkstemp(fname);
+		if((fd == -1) || (ftruncate(fd, (off_t)ms*SAMPS_MS*sizeof(CPX)) != 0))
+		{
+			fprintf(stderr,"Could not create %s, aborting.\n",fname);
+			exit(1);
+		}
+		for(lcv = 0; lcv < ms; lcv++)
+		{
+			tag.i = lcv;
+			tag.q = ~lcv;
+			pwrite(fd, &tag, sizeof(CPX), (off_t)lcv*SAMPS_MS*sizeof(CPX));
+		}
+		close(fd);
+
+		memset(&fopt, 0x0, sizeof(Options_S));
+		fopt.source = SOURCE_FILE;
+		fopt.fifo_depth = depth = FILE_WINDOW_MS - 1;
+		strcpy(fopt.file_name_1, fname);
+
+		source = new GPS_Source(&fopt);
+		packet = new ms_packet;
+		held = new CPX *[depth];
+
+		/* Play twice through, every packet must stay readable until a FIFO depth later */
+		for(lcv = 0; lcv < 2*ms + depth; lcv++)
+		{
+			lcv2 = lcv % depth;
+			if(lcv >= depth)
+			{
+				val1 = (lcv - depth) % ms;
+				if((held[lcv2][0].i != (int16)val1) || (held[lcv2][0].q != (int16)~val1))
+					err++;
+			}
+
+			source->Read(packet);
+			held[lcv2] = packet->payload[0];
+
+			if(held[lcv2][0].i != (int16)(lcv % ms))
+				err++;
+		}
+
+		delete [] held;
+		delete packet;
+		delete source;
+		unlink(fname);
+
+	}
+	if(err)
+		fprintf(stdout,"FILE LOOP \t\t\tFAILED: %d\n",err);
+	else
+		fprintf(stdout,"FILE LOOP \t\t\tPASSED\n",err);
+	/*----------------------------------------------------------------------------------------------*/
+
 	delete [] testvecta;
 	delete [] testvectb;
 	delete [] testvectc;
@@ -557,6 +884,9 @@ int main(int32 argc, char* argv[])
 	delete [] testvectf;
 	delete [] testvectg;
 	delete [] testvecth;
+	delete [] testbytes;
+	delete [] testloopa;
+	delete [] testloopb;
 
 	return(1);
 
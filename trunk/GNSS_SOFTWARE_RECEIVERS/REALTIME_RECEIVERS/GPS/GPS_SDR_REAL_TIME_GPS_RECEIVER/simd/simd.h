@@ -60,6 +60,11 @@ void  sse_cmulsc(CPX *A, CPX *B, CPX *C, int32 cnt, int32 shift) __attribute__ (
 void  sse_prn_accum(CPX *A, CPX *E, CPX *P, CPX *L, int32 cnt, CPX *accum) __attribute__ ((noinline));  //!< This is a long story
 void  sse_prn_accum_new(CPX *A, MIX *E, MIX *P, MIX *L, int32 cnt, CPX_ACCUM *accum) __attribute__ ((noinline));  //!< This is a long story
 void  sse_max(int32 *_A, int32 *_index, int32 *_magt, int32 _cnt) __attribute__ ((noinline));
+void  sse_unpack8(int8 *A, CPX *B, int32 cnt) __attribute__ ((noinline));								//!< Unpack 8 bit I/Q samples
+void  sse_unpack4(uint8 *A, CPX *B, int32 cnt) __attribute__ ((noinline));								//!< Unpack 4 bit I/Q samples
+void  sse_unpack2(uint8 *A, CPX *B, int32 cnt) __attribute__ ((noinline));								//!< Unpack 2 bit I/Q samples
+int32 sse_agc(CPX *A, int32 cnt, int32 bits, int32 scale) __attribute__ ((noinline));						//!< Rounded shift in place, count overflows
+void  sse_loops(Loop_Block_S *B, int32 cnt) __attribute__ ((noinline));									//!< Close the tracking loops, 4 channels at a time
 /*----------------------------------------------------------------------------------------------*/
 
 /* Found in x86.cpp */
@@ -79,6 +84,9 @@ void  x86_cmag(CPX *A, int32 cnt);											//!< Convert from complex to a powe
 void  x86_prn_accum(CPX *A, CPX *E, CPX *P, CPX *L, int32 cnt, CPX *accum);  //!< This is a long story
 void  x86_prn_accum_new(CPX *A, MIX *E, MIX *P, MIX *L, int32 cnt, CPX_ACCUM *accum);  //!< This is a long story
 void  x86_max(int32 *_A, int32 *_index, int32 *_magt, int32 _cnt);
+void  x86_unpack(uint8 *_A, CPX *_B, int32 _cnt, int32 _bits);			//!< Unpack 2, 4, or 8 bit I/Q samples
+void  x86_pack(CPX *_A, uint8 *_B, int32 _cnt, int32 _bits, int32 _shift);	//!< Pack to 2, 4, or 8 bit I/Q samples
+void  x86_loops(Loop_Block_S *_B, int32 _cnt);								//!< Close the tracking loops
 /*----------------------------------------------------------------------------------------------*/
 
 
@@ -1030,6 +1030,379 @@ void sse_prn_accum_new(CPX *A, MIX *E, MIX *P, MIX *L, int32 cnt, CPX_ACCUM *acc
 }
 
 
+void sse_unpack8(int8 *A, CPX *B, int32 cnt)
+{
+
+	int32 cnt1;
+	int32 cnt2;
+
+	cnt1 = cnt/8;
+	cnt2 = cnt-8*cnt1;
+
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix			\n\t" //Set up for loop
+		"jecxz Z%=						\n\t"
+		"L%=:							\n\t"
+		"	movdqu		xmm0, [esi]		\n\t" //Load 8 samples [I Q I Q ...] bytes
+		"	movdqa		xmm1, xmm0		\n\t"
+		"	punpcklbw	xmm0, xmm0		\n\t" //Duplicate each byte into a word
+		"	punpckhbw	xmm1, xmm1		\n\t"
+		"	psraw		xmm0, 8			\n\t" //Shift down to sign extend
+		"	psraw		xmm1, 8			\n\t"
+		"	movdqu		[edi], xmm0		\n\t" //Store 8 CPX
+		"	movdqu		[edi+16], xmm1	\n\t"
+		"	add			esi, 16			\n\t"
+		"	add			edi, 32			\n\t"
+		"loop L%=						\n\t" //Loop if not done
+		"Z%=:							\n\t"
+		".att_syntax					\n\t"
+		: "+S" (A), "+D" (B), "+c" (cnt1)
+		:
+		: "memory"
+	);
+
+	/* Leftovers */
+	x86_unpack((uint8 *)A, B, cnt2, 8);
+
+}
+
+
+void sse_unpack4(uint8 *A, CPX *B, int32 cnt)
+{
+
+	int32 cnt1;
+	int32 cnt2;
+
+	cnt1 = cnt/8;
+	cnt2 = cnt-8*cnt1;
+
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix			\n\t" //Set up for loop
+		"jecxz Z%=						\n\t"
+		"L%=:							\n\t"
+		"	movq		xmm0, [esi]		\n\t" //Load 8 samples, [Q:I] nibbles
+		"	punpcklbw	xmm0, xmm0		\n\t" //Duplicate each byte into a word
+		"	movdqa		xmm1, xmm0		\n\t"
+		"	psllw		xmm0, 12		\n\t" //Low nibble to the top and back to sign extend I
+		"	psraw		xmm0, 12		\n\t"
+		"	psllw		xmm1, 8			\n\t" //High nibble to the top and back to sign extend Q
+		"	psraw		xmm1, 12		\n\t"
+		"	movdqa		xmm2, xmm0		\n\t"
+		"	punpcklwd	xmm0, xmm1		\n\t" //Interleave into [I Q I Q ...]
+		"	punpckhwd	xmm2, xmm1		\n\t"
+		"	movdqu		[edi], xmm0		\n\t" //Store 8 CPX
+		"	movdqu		[edi+16], xmm2	\n\t"
+		"	add			esi, 8			\n\t"
+		"	add			edi, 32			\n\t"
+		"loop L%=						\n\t" //Loop if not done
+		"Z%=:							\n\t"
+		".att_syntax					\n\t"
+		: "+S" (A), "+D" (B), "+c" (cnt1)
+		:
+		: "memory"
+	);
+
+	/* Leftovers */
+	x86_unpack(A, B, cnt2, 4);
+
+}
+
+
+/*!
+ * sse_unpack2: Same as x86_unpack for 2 bits. Each byte is spread over 4 words, a multiply moves its
+ * [I0 Q0 I1 Q1] codes to the top of the words in turn, they are shifted down and mapped to 2*code - 3.
+ * */
+void sse_unpack2(uint8 *A, CPX *B, int32 cnt)
+{
+
+	int32 cnt1;
+	int32 cnt2;
+	int32 lcv;
+	int16 par[16];
+
+	cnt1 = cnt/8;
+	cnt2 = cnt-8*cnt1;
+
+	for(lcv = 0; lcv < 8; lcv++)
+	{
+		par[lcv]	= 1 << (14 - 2*(lcv & 0x3));	//Code lcv&3 to bits 14-15
+		par[lcv+8]	= 3;
+	}
+
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix			\n\t" //Set up for loop
+		"movdqu		xmm6, [eax]			\n\t" //Multipliers
+		"movdqu		xmm7, [eax+16]		\n\t" //Threes
+		"jecxz Z%=						\n\t"
+		"L%=:							\n\t"
+		"	movd		xmm0, [esi]		\n\t" //Load 8 samples, 4 bytes
+		"	punpcklbw	xmm0, xmm0		\n\t" //Each byte to 4 words
+		"	punpcklwd	xmm0, xmm0		\n\t"
+		"	movdqa		xmm1, xmm0		\n\t"
+		"	punpckldq	xmm0, xmm0		\n\t"
+		"	punpckhdq	xmm1, xmm1		\n\t"
+		"	pmullw		xmm0, xmm6		\n\t" //Select the code of each word
+		"	pmullw		xmm1, xmm6		\n\t"
+		"	psrlw		xmm0, 14		\n\t"
+		"	psrlw		xmm1, 14		\n\t"
+		"	paddw		xmm0, xmm0		\n\t" //2*code - 3
+		"	paddw		xmm1, xmm1		\n\t"
+		"	psubw		xmm0, xmm7		\n\t"
+		"	psubw		xmm1, xmm7		\n\t"
+		"	movdqu		[edi], xmm0		\n\t" //Store 8 CPX
+		"	movdqu		[edi+16], xmm1	\n\t"
+		"	add			esi, 4			\n\t"
+		"	add			edi, 32			\n\t"
+		"loop L%=						\n\t" //Loop if not done
+		"Z%=:							\n\t"
+		".att_syntax					\n\t"
+		: "+S" (A), "+D" (B), "+c" (cnt1)
+		: "a" (par)
+		: "memory"
+	);
+
+	/* Leftovers */
+	x86_unpack(A, B, cnt2, 2);
+
+}
+
+
+/*!
+ * sse_agc: Same as run_agc, round and shift down by scale in place, then count the components whose
+ * magnitude is above 1 << bits. The constants are handed over (and the counts back) in par.
+ * */
+int32 sse_agc(CPX *A, int32 cnt, int32 bits, int32 scale)
+{
+
+	int32 cnt1;
+	int32 cnt2;
+	int32 lcv, num;
+	int16 par[40];
 
+	cnt1 = cnt/4;
+	cnt2 = cnt-4*cnt1;
 
+	for(lcv = 0; lcv < 8; lcv++)
+	{
+		par[lcv]	= scale ? (1 << (scale - 1)) : 0;	//Rounding
+		par[lcv+8]	= 1 << bits;						//Overflow above
+		par[lcv+16]	= -(1 << bits);						//Overflow below
+		par[lcv+32]	= 0;
+	}
+	memcpy(&par[24], &scale, sizeof(int32));			//Shift
 
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix			\n\t" //Set up for loop
+		"movdqu		xmm7, [edi]			\n\t" //Rounding
+		"movdqu		xmm6, [edi+16]		\n\t" //Max
+		"movdqu		xmm5, [edi+32]		\n\t" //-Max
+		"movd		xmm3, [edi+48]		\n\t" //Shift
+		"pxor		xmm4, xmm4			\n\t" //Overflow counts
+		"jecxz Z%=						\n\t"
+		"L%=:							\n\t"
+		"	movdqu		xmm0, [esi]		\n\t" //Load 4 samples
+		"	paddw		xmm0, xmm7		\n\t" //Round
+		"	psraw		xmm0, xmm3		\n\t" //Shift
+		"	movdqu		[esi], xmm0		\n\t" //Store back
+		"	movdqa		xmm1, xmm0		\n\t"
+		"	pcmpgtw		xmm1, xmm6		\n\t" //x > max
+		"	movdqa		xmm2, xmm5		\n\t"
+		"	pcmpgtw		xmm2, xmm0		\n\t" //-max > x
+		"	por			xmm1, xmm2		\n\t"
+		"	psubw		xmm4, xmm1		\n\t" //Count (mask is -1)
+		"	add			esi, 16			\n\t"
+		"loop L%=						\n\t" //Loop if not done
+		"Z%=:							\n\t"
+		"movdqu		[edi+64], xmm4		\n\t" //Hand back the counts
+		".att_syntax					\n\t"
+		: "+S" (A), "+c" (cnt1)
+		: "D" (par)
+		: "memory"
+	);
+
+	num = 0;
+	for(lcv = 32; lcv < 40; lcv++)
+		num += (uint16)par[lcv];
+
+	/* Leftovers */
+	num += run_agc(A, cnt2, bits, scale);
+
+	return(num);
+
+}
+
+
+
+
+
+/*!
+ * sse_loops: Close the tracking loops of every channel loaded into the _cnt blocks, 4 channels per
+ * pass. atan() is the Cephes single precision one, range reduced about tan(pi/8) and tan(3pi/8), with
+ * the 4 branches done as masks. Blocks with nothing loaded are skipped. Same results as x86_loops to
+ * within single precision.
+ * */
+void sse_loops(Loop_Block_S *B, int32 cnt)
+{
+
+	int32 lcv;
+	float par[64];
+	uint32 sign = 0x80000000;
+	uint32 mask = 0x7FFFFFFF;
+
+	for(lcv = 0; lcv < 4; lcv++)
+	{
+		par[lcv]		= 1.0/TWO_PI;					//Cycles
+		par[lcv+4]		= 0.5;
+		par[lcv+8]		= 0.5*CODE_RATE*INVERSE_L1;		//Carrier aiding of the code
+		par[lcv+12]		= -5.0;							//Code pull in
+		memcpy(&par[lcv+16], &sign, sizeof(float));		//Sign
+		memcpy(&par[lcv+20], &mask, sizeof(float));		//Abs
+		par[lcv+24]		= 2.414213562373095;			//tan(3pi/8)
+		par[lcv+28]		= 0.4142135623730950;			//tan(pi/8)
+		par[lcv+32]		= 1.0;
+		par[lcv+36]		= -1.0;
+		par[lcv+40]		= PI/2.0;
+		par[lcv+44]		= PI/4.0;
+		par[lcv+48]		= 8.05374449538e-2;				//atan polynomial
+		par[lcv+52]		= -1.38776856032e-1;
+		par[lcv+56]		= 1.99777106478e-1;
+		par[lcv+60]		= -3.33329491539e-1;
+	}
+
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix			\n\t" //Set up for loop
+		"test		ecx, ecx			\n\t" //Too far for jecxz
+		"jz			Z%=					\n\t"
+		"L%=:							\n\t"
+		"	movups		xmm7, [esi+96]	\n\t" //Loaded
+		"	movmskps	eax, xmm7		\n\t"
+		"	test		eax, eax		\n\t"
+		"	jz			N%=				\n\t" //Nothing to do in this block
+
+		/* atan(Q/I) */
+		"	movups		xmm0, [esi+16]	\n\t" //Q
+		"	movups		xmm1, [esi]		\n\t" //I
+		"	divps		xmm0, xmm1		\n\t" //r = Q/I
+		"	movups		xmm6, [edi+64]	\n\t"
+		"	andps		xmm6, xmm0		\n\t" //Sign of r
+		"	movups		xmm2, [edi+80]	\n\t"
+		"	andps		xmm0, xmm2		\n\t" //a = |r|
+		"	movups		xmm2, [edi+96]	\n\t"
+		"	cmpltps		xmm2, xmm0		\n\t" //Big, a > tan(3pi/8)
+		"	movups		xmm3, [edi+112]	\n\t"
+		"	cmpltps		xmm3, xmm0		\n\t" //a > tan(pi/8)
+		"	movaps		xmm4, xmm2		\n\t"
+		"	andnps		xmm4, xmm3		\n\t" //Mid, tan(pi/8) < a <= tan(3pi/8)
+		"	movups		xmm3, [edi+160]	\n\t"
+		"	andps		xmm3, xmm2		\n\t" //pi/2 if big
+		"	movups		xmm5, [edi+176]	\n\t"
+		"	andps		xmm5, xmm4		\n\t" //pi/4 if mid
+		"	orps		xmm3, xmm5		\n\t" //Offset y0
+		"	movups		xmm5, [edi+128]	\n\t" //1
+		"	movaps		xmm1, xmm0		\n\t"
+		"	subps		xmm1, xmm5		\n\t" //a-1
+		"	addps		xmm5, xmm0		\n\t" //a+1
+		"	divps		xmm1, xmm5		\n\t"
+		"	andps		xmm1, xmm4		\n\t" //(a-1)/(a+1) if mid
+		"	movups		xmm5, [edi+144]	\n\t"
+		"	divps		xmm5, xmm0		\n\t"
+		"	andps		xmm5, xmm2		\n\t" //-1/a if big
+		"	orps		xmm1, xmm5		\n\t"
+		"	orps		xmm4, xmm2		\n\t"
+		"	andnps		xmm4, xmm0		\n\t" //a otherwise
+		"	orps		xmm1, xmm4		\n\t" //Reduced argument x
+		"	movaps		xmm0, xmm1		\n\t"
+		"	mulps		xmm0, xmm1		\n\t" //z = x*x
+		"	movups		xmm2, [edi+192]	\n\t"
+		"	mulps		xmm2, xmm0		\n\t"
+		"	movups		xmm4, [edi+208]	\n\t"
+		"	addps		xmm2, xmm4		\n\t"
+		"	mulps		xmm2, xmm0		\n\t"
+		"	movups		xmm4, [edi+224]	\n\t"
+		"	addps		xmm2, xmm4		\n\t"
+		"	mulps		xmm2, xmm0		\n\t"
+		"	movups		xmm4, [edi+240]	\n\t"
+		"	addps		xmm2, xmm4		\n\t"
+		"	mulps		xmm2, xmm0		\n\t"
+		"	mulps		xmm2, xmm1		\n\t"
+		"	addps		xmm2, xmm1		\n\t" //x + x*z*p(z)
+		"	addps		xmm2, xmm3		\n\t" //+ y0
+		"	xorps		xmm2, xmm6		\n\t" //Put the sign back
+		"	movups		xmm4, [edi]		\n\t"
+		"	mulps		xmm2, xmm4		\n\t" //Phase error in cycles
+
+		/* PLL, only where I != 0 and FrequencyLock() is done */
+		"	movups		xmm1, [esi]		\n\t"
+		"	xorps		xmm0, xmm0		\n\t"
+		"	cmpneqps	xmm1, xmm0		\n\t"
+		"	andps		xmm2, xmm1		\n\t" //dp = 0 if I == 0
+		"	movups		xmm6, [esi+64]	\n\t"
+		"	andps		xmm6, xmm7		\n\t" //Lanes running the PLL
+		"	andps		xmm2, xmm6		\n\t" //dp
+		"	movups		xmm0, [esi+112]	\n\t"
+		"	mulps		xmm0, xmm2		\n\t"
+		"	movups		xmm1, [esi+176]	\n\t"
+		"	addps		xmm1, xmm0		\n\t"
+		"	movups		[esi+176], xmm1	\n\t" //w += kw*dp
+		"	movups		xmm0, [esi+160]	\n\t"
+		"	mulps		xmm0, xmm1		\n\t"
+		"	movups		xmm3, [esi+128]	\n\t"
+		"	mulps		xmm3, xmm2		\n\t"
+		"	addps		xmm0, xmm3		\n\t"
+		"	andps		xmm0, xmm6		\n\t"
+		"	movups		xmm1, [esi+192]	\n\t"
+		"	addps		xmm1, xmm0		\n\t"
+		"	movups		[esi+192], xmm1	\n\t" //x += kh*w + kx*dp
+		"	movups		xmm0, [edi+16]	\n\t"
+		"	mulps		xmm0, xmm1		\n\t"
+		"	movups		xmm3, [esi+144]	\n\t"
+		"	mulps		xmm3, xmm2		\n\t"
+		"	addps		xmm0, xmm3		\n\t"
+		"	andps		xmm0, xmm6		\n\t"
+		"	movups		xmm3, [esi+208]	\n\t"
+		"	andnps		xmm6, xmm3		\n\t"
+		"	orps		xmm0, xmm6		\n\t"
+		"	movups		[esi+208], xmm0	\n\t" //z = x/2 + kz*dp
+
+		/* DLL */
+		"	movups		xmm0, [esi+32]	\n\t" //Early
+		"	movups		xmm2, [esi+48]	\n\t" //Late
+		"	movaps		xmm3, xmm0		\n\t"
+		"	addps		xmm3, xmm2		\n\t"
+		"	sqrtps		xmm0, xmm0		\n\t"
+		"	sqrtps		xmm2, xmm2		\n\t"
+		"	sqrtps		xmm3, xmm3		\n\t"
+		"	subps		xmm0, xmm2		\n\t"
+		"	divps		xmm0, xmm3		\n\t" //(E-L)/(E+L)
+		"	movups		xmm2, [esi+80]	\n\t"
+		"	movups		xmm3, [edi+48]	\n\t"
+		"	andps		xmm3, xmm2		\n\t"
+		"	andnps		xmm2, xmm0		\n\t"
+		"	orps		xmm2, xmm3		\n\t" //Or pull in
+		"	movups		xmm0, [edi+32]	\n\t"
+		"	mulps		xmm0, xmm1		\n\t" //Carrier aiding
+		"	addps		xmm0, xmm2		\n\t"
+		"	andps		xmm0, xmm7		\n\t"
+		"	movups		xmm3, [esi+224]	\n\t"
+		"	andnps		xmm7, xmm3		\n\t"
+		"	orps		xmm0, xmm7		\n\t"
+		"	movups		[esi+224], xmm0	\n\t" //Code NCO
+		"	xorps		xmm0, xmm0		\n\t"
+		"	movups		[esi+96], xmm0	\n\t" //Unload
+		"N%=:							\n\t"
+		"	add			esi, 240		\n\t"
+		"	dec			ecx				\n\t"
+		"	jnz			L%=				\n\t" //Loop if not done
+		"Z%=:							\n\t"
+		".att_syntax					\n\t"
+		: "+S" (B), "+c" (cnt)
+		: "D" (par)
+		: "eax", "memory"
+	);
+
+}
@@ -387,6 +387,113 @@ void x86_prn_accum_new(CPX *A, MIX *E, MIX *P, MIX *L, int32 cnt, CPX_ACCUM *acc
 /*----------------------------------------------------------------------------------------------*/
 
 
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * x86_unpack: Unpack _cnt packed samples. 8 bit is signed [I Q] bytes, 4 bit is one byte per sample
+ * with I in the low nibble and Q in the high nibble (two's complement), 2 bit is two samples per byte,
+ * I0 Q0 I1 Q1 from the LSB up with codes 0..3 meaning -3, -1, +1, +3 (_cnt must be even).
+ * */
+void x86_unpack(uint8 *_A, CPX *_B, int32 _cnt, int32 _bits)
+{
+
+	static CPX lut[256][2];
+	static bool lut_init = false;
+	int8 *p;
+	int32 lcv;
+
+	p = (int8 *)_A;
+
+	switch(_bits)
+	{
+		case 8:
+			for(lcv = 0; lcv < _cnt; lcv++)
+			{
+				_B[lcv].i = p[2*lcv];
+				_B[lcv].q = p[2*lcv+1];
+			}
+			break;
+		case 4:
+			for(lcv = 0; lcv < _cnt; lcv++)
+			{
+				_B[lcv].i = (int8)(_A[lcv] << 4) >> 4;
+				_B[lcv].q = p[lcv] >> 4;
+			}
+			break;
+		case 2:
+			/* Table lookup, 2 samples per byte */
+			if(!lut_init)
+			{
+				for(lcv = 0; lcv < 256; lcv++)
+				{
+					lut[lcv][0].i = 2*((lcv     ) & 0x3) - 3;
+					lut[lcv][0].q = 2*((lcv >> 2) & 0x3) - 3;
+					lut[lcv][1].i = 2*((lcv >> 4) & 0x3) - 3;
+					lut[lcv][1].q = 2*((lcv >> 6) & 0x3) - 3;
+				}
+				lut_init = true;
+			}
+
+			for(lcv = 0; lcv < _cnt/2; lcv++)
+				memcpy(&_B[2*lcv], &lut[_A[lcv]][0], 2*sizeof(CPX));
+
+			/* An odd count ends on the low half of a byte */
+			if(_cnt & 0x1)
+				_B[_cnt-1] = lut[_A[_cnt/2]][0];
+			break;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * x86_pack: Inverse of x86_unpack, samples are shifted down by _shift and saturated first.
+ * */
+void x86_pack(CPX *_A, uint8 *_B, int32 _cnt, int32 _bits, int32 _shift)
+{
+
+	int32 lcv, i, q, lim;
+	uint8 code[2];
+
+	lim = 1 << (_bits - 1);
+
+	for(lcv = 0; lcv < _cnt; lcv++)
+	{
+		i = _A[lcv].i >> _shift;
+		q = _A[lcv].q >> _shift;
+
+		if(_bits == 2)
+		{
+			/* Nearest of -3, -1, +1, +3 */
+			code[0] = (i >= 2) ? 3 : (i >= 0) ? 2 : (i >= -2) ? 1 : 0;
+			code[1] = (q >= 2) ? 3 : (q >= 0) ? 2 : (q >= -2) ? 1 : 0;
+
+			if(lcv & 0x1)
+				_B[lcv/2] |= (code[0] << 4) | (code[1] << 6);
+			else
+				_B[lcv/2] = code[0] | (code[1] << 2);
+			continue;
+		}
+
+		if(i >= lim) i = lim - 1;
+		if(i < -lim) i = -lim;
+		if(q >= lim) q = lim - 1;
+		if(q < -lim) q = -lim;
+
+		if(_bits == 8)
+		{
+			_B[2*lcv] = (uint8)i;
+			_B[2*lcv+1] = (uint8)q;
+		}
+		else
+			_B[lcv] = (i & 0xF) | ((q & 0xF) << 4);
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
 //int32 x86_acc(int16 *_A, int32 _cnt)
 //{
 //
@@ -460,3 +567,50 @@ void x86_prn_accum_new(CPX *A, MIX *E, MIX *P, MIX *L, int32 cnt, CPX_ACCUM *acc
 //	}
 //
 //}
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * x86_loops: Close the tracking loops of every channel loaded into the _cnt blocks, see sse_loops.
+ * */
+void x86_loops(Loop_Block_S *_B, int32 _cnt)
+{
+
+	int32 lcv, lane;
+	float dp, err;
+	Loop_Block_S *b;
+
+	for(lcv = 0; lcv < _cnt; lcv++)
+	{
+		b = &_B[lcv];
+		for(lane = 0; lane < 4; lane++)
+		{
+			if(b->load[lane] == 0)
+				continue;
+
+			/* PLL discriminator and 3rd order loop filter */
+			if(b->pll[lane])
+			{
+				dp = 0;
+				if(b->ip[lane] != 0)
+					dp = atan((double)b->qp[lane]/(double)b->ip[lane])/TWO_PI;
+
+				b->w[lane] += b->kw[lane]*dp;
+				b->x[lane] += b->kh[lane]*b->w[lane] + b->kx[lane]*dp;
+				b->z[lane] = 0.5*b->x[lane] + b->kz[lane]*dp;
+			}
+
+			/* Normalized early minus late envelope, or pull in while the correlation is weak */
+			if(b->pull[lane])
+				err = -5.0;
+			else
+				err = (sqrt(b->pe[lane]) - sqrt(b->pl[lane]))/sqrt(b->pe[lane] + b->pl[lane]);
+
+			b->code[lane] = 0.5*b->x[lane]*CODE_RATE*INVERSE_L1 + err;
+
+			b->load[lane] = 0;
+		}
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
@@ -30,10 +30,10 @@
 static char debug = 1; //!< 1 = Verbose
 
 /*----------------------------------------------------------------------------------------------*/
-gn3s::gn3s(int _which)
+gn3s::gn3s(int _which, int _simulate, double _pace, int _ring_blocks)
 {
 
-	int fsize;
+	int fsize, lcv;
 	bool ret;
 	which = _which;
 
@@ -42,6 +42,33 @@ gn3s::gn3s(int _which)
 	gn3s_vid 	= GN3S_VID;
 	gn3s_pid 	= GN3S_PID;
 
+	/* The sample ring */
+	simulate = _simulate;
+	pace = _pace;
+	ring_blocks = (_ring_blocks > 1) ? _ring_blocks : 2;
+	ring_size = (long long)ring_blocks*FUSB_BLOCK_SIZE;
+	ring = new char[ring_size];
+	head = tail = 0;
+	overruns = blocks = errors = 0;
+	streaming = 0;
+
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&data, NULL);
+	pthread_cond_init(&space, NULL);
+
+	memset(&fx2_config, 0x0, sizeof(fx2_config));
+
+	if(simulate)
+	{
+		rng = 0x2545F491;
+		sim_phase = 0;
+		for(lcv = 0; lcv < 256; lcv++)
+			sim_cos[lcv] = (signed char)floor(GN3S_SIM_AMP*cos(2*M_PI*(double)lcv/256.0) + 0.5);
+
+		fprintf(stdout, "Simulating GN3S Device\n");
+		return;
+	}
+
 	/* Get the firmware embedded in the executable */
 	fstart = (int) &_binary_usrp_gn3s_firmware_ihx_start;
 	fsize = strlen(_binary_usrp_gn3s_firmware_ihx_start);
@@ -89,14 +116,25 @@ gn3s::gn3s(int _which)
 gn3s::~gn3s()
 {
 
+	Stop();
+
 	//usrp_xfer(VRQ_XFER, 0);
 
 	//delete gn3s_firmware;
-	delete fx2_config.d_ephandle;
-	delete fx2_config.d_devhandle;
+	if(!simulate)
+	{
+		delete fx2_config.d_ephandle;
+		delete fx2_config.d_devhandle;
+
+		usb_release_interface(fx2_config.udev, fx2_config.interface);
+		usb_close(fx2_config.udev);
+	}
+
+	pthread_cond_destroy(&space);
+	pthread_cond_destroy(&data);
+	pthread_mutex_destroy(&mutex);
 
-	usb_release_interface(fx2_config.udev, fx2_config.interface);
-	usb_close(fx2_config.udev);
+	delete [] ring;
 
 }
 /*----------------------------------------------------------------------------------------------*/
@@ -465,9 +503,238 @@ fusb_devhandle* gn3s::make_devhandle(usb_dev_handle *udh)
 
 
 /*----------------------------------------------------------------------------------------------*/
+void *GN3S_Thread(void *_arg)
+{
+
+	gn3s *device = (gn3s *)_arg;
+
+	device->Stream();
+
+	pthread_exit(0);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void gn3s::Start()
+{
+
+	if(streaming)
+		return;
+
+	streaming = 1;
+	pthread_create(&thread, NULL, GN3S_Thread, (void *)this);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Stop: The streaming thread checks the flag after every block, a bulk read finishes within a few ms.
+ * */
+void gn3s::Stop()
+{
+
+	if(!streaming)
+		return;
+
+	pthread_mutex_lock(&mutex);
+	streaming = 0;
+	pthread_cond_broadcast(&space);
+	pthread_mutex_unlock(&mutex);
+
+	pthread_join(thread, NULL);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Stream: Land each block straight in its slot of the ring, then complete it. A block is only ever
+ * filled while its slot is free, so the reader never sees a partial block.
+ * */
+void gn3s::Stream()
+{
+
+	char *block;
+
+	if(simulate)
+		gettimeofday(&sim_t0, NULL);
+
+	while(streaming)
+	{
+		pthread_mutex_lock(&mutex);
+
+		/* Make room for the next block */
+		if(head - tail + FUSB_BLOCK_SIZE > ring_size)
+		{
+			if(simulate && (pace <= 0))
+			{
+				/* Nothing is lost by waiting on a simulated device */
+				while(streaming && (head - tail + FUSB_BLOCK_SIZE > ring_size))
+					pthread_cond_wait(&space, &mutex);
+			}
+			else
+			{
+				/* Drop the oldest block, the reader has fallen behind */
+				tail = head + FUSB_BLOCK_SIZE - ring_size;
+				overruns++;
+			}
+		}
+
+		block = &ring[head % ring_size];
+		pthread_mutex_unlock(&mutex);
+
+		if(!streaming)
+			break;
+
+		Fill(block);
+		Complete();
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void gn3s::Fill(char *_block)
+{
+
+	int bread, got;
+
+	if(simulate)
+	{
+		Simulate(_block);
+		return;
+	}
+
+	/* The endpoint may hand back less than a block at a time */
+	got = 0;
+	while(streaming && (got < FUSB_BLOCK_SIZE))
+	{
+		bread = fx2_config.d_ephandle->read(&_block[got], FUSB_BLOCK_SIZE - got);
+		if(bread <= 0)
+		{
+			errors++;
+			usleep(1000);
+			continue;
+		}
+		got += bread;
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * Simulate: A real carrier at the GN3S IF plus roughly Gaussian noise (sum of 4 uniform bytes), quantized
+ * to the 2 bit codes of the sampler, paced to GN3S_SIM_RATE times the pace.
+ * */
+void gn3s::Simulate(char *_block)
+{
+
+	int lcv, v;
+	unsigned int r;
+	double elapsed, target;
+	struct timeval now;
+
+	for(lcv = 0; lcv < FUSB_BLOCK_SIZE; lcv++)
+	{
+		/* xorshift32 */
+		r = rng;
+		r ^= r << 13;
+		r ^= r >> 17;
+		r ^= r << 5;
+		rng = r;
+
+		v = (int)(r & 0xff) + (int)((r >> 8) & 0xff) + (int)((r >> 16) & 0xff) + (int)(r >> 24) - 510;
+		v += sim_cos[sim_phase >> 24];
+		sim_phase += GN3S_SIM_DPHASE;
+
+		if(v < -GN3S_SIM_NOISE)
+			_block[lcv] = 0;
+		else if(v < 0)
+			_block[lcv] = 1;
+		else if(v < GN3S_SIM_NOISE)
+			_block[lcv] = 2;
+		else
+			_block[lcv] = 3;
+	}
+
+	/* Hold back to the sample rate */
+	if(pace > 0)
+	{
+		gettimeofday(&now, NULL);
+		elapsed = (double)(now.tv_sec - sim_t0.tv_sec)*1e6 + (double)(now.tv_usec - sim_t0.tv_usec);
+		target = (double)(blocks + 1)*FUSB_BLOCK_SIZE*1e6/(GN3S_SIM_RATE*pace);
+
+		if(target > elapsed)
+			usleep((useconds_t)(target - elapsed));
+	}
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+void gn3s::Complete()
+{
+
+	pthread_mutex_lock(&mutex);
+	head += FUSB_BLOCK_SIZE;
+	blocks++;
+	pthread_cond_signal(&data);
+	pthread_mutex_unlock(&mutex);
+
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+static void gn3s_unlock(void *_arg)
+{
+	pthread_mutex_unlock((pthread_mutex_t *)_arg);
+}
+/*----------------------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------------------------*/
+/*!
+ * read: Copy bytes out of the ring, waiting only if the streaming thread has not completed them yet.
+ * Keeps the blocking semantics of the endpoint read, and is safe to cancel while waiting.
+ * */
 int gn3s::read(void *buff, int bytes)
 {
-	return(fx2_config.d_ephandle->read(buff, bytes));
+
+	long long start;
+	int first;
+
+	if(bytes > ring_size)
+		bytes = ring_size;
+
+	pthread_mutex_lock(&mutex);
+	pthread_cleanup_push(gn3s_unlock, (void *)&mutex);
+
+	while(head - tail < bytes)
+		pthread_cond_wait(&data, &mutex);
+
+	start = tail % ring_size;
+	first = (start + bytes > ring_size) ? (int)(ring_size - start) : bytes;
+
+	memcpy(buff, &ring[start], first);
+	memcpy((char *)buff + first, &ring[0], bytes - first);
+
+	tail += bytes;
+	pthread_cond_signal(&space);
+
+	pthread_cleanup_pop(1);
+
+	return(bytes);
+
 }
 /*----------------------------------------------------------------------------------------------*/
 
@@ -477,6 +744,10 @@ bool gn3s::check_rx_overrun()
 {
 	bool overrun;
 
+	if(simulate)
+		return(false);
+
+	overrun = false;
 	_get_status(GS_RX_OVERRUN, &overrun);
 
 	return(overrun);
@@ -516,6 +787,9 @@ int gn3s::write_cmd(int request, int value, int index, unsigned char *bytes, int
 	int requesttype;
 	int r;
 
+	if(simulate)
+		return(len);
+
 	requesttype = (request & 0x80) ? VRT_VENDOR_IN : VRT_VENDOR_OUT;
 	r = usb_control_msg (fx2_config.udev, requesttype, request, value, index, (char *) bytes, len, 1000);
 	if(r < 0)
@@ -39,6 +39,8 @@
 #include <math.h>
 #include <usb.h>
 #include <stdint.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include "fusb.h"
 #include "fusb_linux.h"
 #include "usrp_bytesex.h"
@@ -82,6 +84,11 @@ struct fx2Config
 #define FUSB_BUFFER_SIZE 	(16 * (1L << 20)) 	//!< 8 MB
 #define FUSB_BLOCK_SIZE  	(16 * (1L << 10)) 	//!< 16KB is hard limit
 #define FUSB_NBLOCKS		(FUSB_BUFFER_SIZE / FUSB_BLOCK_SIZE)
+#define GN3S_RING_BLOCKS	(256)				//!< Default depth of the sample ring in FUSB_BLOCK_SIZE blocks (~1 s)
+#define GN3S_SIM_RATE		(4000000)			//!< Bytes per second produced by the simulated device
+#define GN3S_SIM_DPHASE		(2557223528u)		//!< Phase step of the simulated carrier, lands on the mixer
+#define GN3S_SIM_AMP		(40)				//!< Amplitude of the simulated carrier
+#define GN3S_SIM_NOISE		(148)				//!< 1 sigma of the simulated noise, also the 2 bit threshold
 /*--------------------------------------------------------------*/
 
 
@@ -91,9 +98,17 @@ extern char _binary_usrp_gn3s_firmware_ihx_start[];
 /*--------------------------------------------------------------*/
 
 
+/*--------------------------------------------------------------*/
+void *GN3S_Thread(void *_arg);
+/*--------------------------------------------------------------*/
+
+
 /*--------------------------------------------------------------*/
 /*! \ingroup CLASSES
- *
+ *  @brief The GN3S sampler. A streaming thread keeps the bulk endpoint drained (the endpoint handle
+ *  itself keeps FUSB_NBLOCKS transfers in flight) and completes each FUSB_BLOCK_SIZE block into a ring,
+ *  so read() never waits on the USB. When the ring is full the oldest block is dropped and counted.
+ *  In simulation the blocks come from a carrier plus noise generator instead of the hardware.
  */
 class gn3s
 {
@@ -116,11 +131,43 @@ class gn3s
 		int fsize;
 		char *gn3s_firmware;
 
+		/* Streaming */
+		int simulate;			//!< Generate the samples instead of opening the hardware
+		double pace;			//!< Simulated rate as a multiple of real time, 0 is as fast as the reader goes
+		pthread_t thread;		//!< Streaming thread
+		pthread_mutex_t mutex;	//!< Protects the ring pointers
+		pthread_cond_t data;	//!< Signaled when a block completes
+		pthread_cond_t space;	//!< Signaled when the reader frees space (lossless simulation)
+		volatile int streaming;	//!< Streaming thread runs while set
+		char *ring;				//!< The sample ring
+		int ring_blocks;		//!< Depth of the ring in blocks
+		long long ring_size;	//!< Size of the ring in bytes
+		long long head;			//!< Bytes completed into the ring
+		long long tail;			//!< Bytes consumed from the ring
+		unsigned int overruns;	//!< Blocks dropped because the ring was full
+		unsigned int blocks;	//!< Blocks completed
+		unsigned int errors;	//!< Failed bulk reads
+		unsigned int rng;		//!< Simulated noise state
+		unsigned int sim_phase;	//!< Simulated carrier phase
+		signed char sim_cos[256];	//!< Simulated carrier
+		struct timeval sim_t0;	//!< Wall clock at the start of the simulation
+
+		void Fill(char *_block);		//!< Get one block from the device
+		void Simulate(char *_block);	//!< Make up one block
+		void Complete();				//!< Publish the block at the head of the ring
+
 	public:
 
-		gn3s(int _which);		//!< Constructor
+		gn3s(int _which, int _simulate = 0, double _pace = 1.0, int _ring_blocks = GN3S_RING_BLOCKS);	//!< Constructor
 		~gn3s();				//!< Destructor
 
+		void Start();			//!< Start streaming into the ring
+		void Stop();			//!< Stop streaming
+		void Stream();			//!< Body of the streaming thread
+		unsigned int getOverruns(){return(overruns);}	//!< Blocks lost to a full ring
+		unsigned int getBlocks(){return(blocks);}		//!< Blocks received
+		unsigned int getErrors(){return(errors);}		//!< Failed bulk reads
+
 		/* FX2 functions */
 		struct usb_device* usb_fx2_find(int vid, int pid, char info, int ignore);
 		bool usb_fx2_configure(struct usb_device *fx2, fx2Config *fx2c);